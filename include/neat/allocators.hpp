@@ -4,6 +4,8 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <memory_resource>
+#include <new>
 
 #ifndef NEAT_ALLOCATORS_MALLOC
 #define NEAT_ALLOCATORS_MALLOC std::malloc
@@ -55,10 +57,25 @@ class bump {
     ~bump();
 
     void*                    allocate(std::size_t size);
+    void*                    allocate(std::size_t size, std::size_t alignment);
     template <typename T> T* allocate();
     std::size_t              block_count() const;
 };
 
+// Memory resource adapter so standard pmr containers can allocate from a bump allocator
+// Deallocation is a no-op, memory is only released when the bump allocator is destroyed
+class bump_resource final : public std::pmr::memory_resource {
+   private:
+    bump& _bump;
+
+    void* do_allocate(std::size_t size, std::size_t alignment) override;
+    void  do_deallocate(void* ptr, std::size_t size, std::size_t alignment) override;
+    bool  do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+   public:
+    explicit bump_resource(bump& b);
+};
+
 }  // namespace neat::allocators
 
 #pragma region arena implementations
@@ -122,14 +139,19 @@ inline neat::allocators::bump::~bump() {
 }
 
 inline void* neat::allocators::bump::allocate(std::size_t size) {
+    return allocate(size, 1);
+}
+
+inline void* neat::allocators::bump::allocate(std::size_t size, std::size_t alignment) {
     if (size > _block_size)
         return nullptr;
 
     for (size_t i = 0; i < _block_count; i++) {
-        if (_blocks[i].remaining >= size) {
-            void* ptr = (void*)_blocks[i].current;
-            _blocks[i].current += size / sizeof(uint8_t);
-            _blocks[i].remaining -= size;
+        std::size_t padding = (0 - (std::uintptr_t)_blocks[i].current) & (alignment - 1);
+        if (_blocks[i].remaining >= size + padding) {
+            void* ptr = (void*)(_blocks[i].current + padding);
+            _blocks[i].current += size + padding;
+            _blocks[i].remaining -= size + padding;
             return ptr;
         }
     }
@@ -137,15 +159,18 @@ inline void* neat::allocators::bump::allocate(std::size_t size) {
     block* new_block = (block*)add_block();
     if (!new_block)
         return nullptr;
-    void* ptr = new_block->current;
-    new_block->current += size / sizeof(uint8_t);
-    new_block->remaining -= size;
+    std::size_t padding = (0 - (std::uintptr_t)new_block->current) & (alignment - 1);
+    if (new_block->remaining < size + padding)
+        return nullptr;
+    void* ptr = new_block->current + padding;
+    new_block->current += size + padding;
+    new_block->remaining -= size + padding;
     return ptr;
 }
 
 template <typename T>
 T* neat::allocators::bump::allocate() {
-    return (T*)allocate(sizeof(T));
+    return (T*)allocate(sizeof(T), alignof(T));
 }
 
 inline void* neat::allocators::bump::add_block() {
@@ -179,4 +204,25 @@ inline std::size_t neat::allocators::bump::block_count() const {
 
 #pragma endregion bump implementations
 
+#pragma region bump_resource implementations
+
+inline neat::allocators::bump_resource::bump_resource(bump& b)
+    : _bump(b) {}
+
+inline void* neat::allocators::bump_resource::do_allocate(std::size_t size, std::size_t alignment) {
+    void* ptr = _bump.allocate(size, alignment);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+inline void neat::allocators::bump_resource::do_deallocate(void*, std::size_t, std::size_t) {}
+
+inline bool neat::allocators::bump_resource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+#pragma endregion bump_resource implementations
+
 #endif  // NEAT_ALLOCATORS_HPP_
\ No newline at end of file
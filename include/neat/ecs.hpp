@@ -1,15 +1,59 @@
 #ifndef NEAT_ECS_HPP_
 #define NEAT_ECS_HPP_
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <bitset>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <optional>
 #include <queue>
+#include <ranges>
+#include <span>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <tuple>
 #include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif  // __AVX2__
+
+#ifndef NEAT_ECS_CHUNK_SIZE
+#define NEAT_ECS_CHUNK_SIZE 16384
+#endif  // NEAT_ECS_CHUNK_SIZE
+
 namespace neat::ecs {
 
+// Define NEAT_ECS_PROFILE to record the timings of systems and the operations on component lists
+#ifdef NEAT_ECS_PROFILE
+inline constexpr bool profiling = true;
+#else
+inline constexpr bool profiling = false;
+#endif  // NEAT_ECS_PROFILE
+
 namespace typing {
 
 template <typename...>
@@ -31,360 +75,5224 @@ constexpr int get_index() {
         return 1 + get_index<Type, Tail...>();
 }
 
-template <typename...> inline constexpr auto are_all_classes = std::true_type {};
+template <typename...> inline constexpr auto are_all_classes = std::true_type {};
+
+template <typename T, typename... Ts>
+inline constexpr auto are_all_classes<T, Ts...> = std::bool_constant<(std::is_class_v<T>)&&are_all_classes<Ts...>> {};
+
+template <typename Subset, typename Set> constexpr bool is_subset_of = false;
+template <typename... Ts, typename... Us>
+inline constexpr bool is_subset_of<std::tuple<Ts...>, std::tuple<Us...>> = (is_one_of<Ts, Us...> && ...);
+
+// Readable name of a type, taken from the signature of this function
+template <typename Type>
+std::string_view type_name() {
+#if defined(__clang__) || defined(__GNUC__)
+    std::string_view signature = __PRETTY_FUNCTION__;
+    std::size_t      begin     = signature.find("Type = ") + 7;
+    return signature.substr(begin, signature.find_first_of(";]", begin) - begin);
+#elif defined(_MSC_VER)
+    std::string_view signature = __FUNCSIG__;
+    std::size_t      begin     = signature.find("type_name<") + 10;
+    return signature.substr(begin, signature.rfind(">(void)") - begin);
+#else
+    return typeid(Type).name();
+#endif
+}
+
+}  // namespace typing
+
+using entity_id                = std::size_t;
+using tick_type                = std::uint64_t;
+const entity_id invalid_entity = SIZE_MAX;
+
+// Order in which the ids of removed entities are handed out again
+enum class reuse_policy {
+    fifo,          // Least recently removed id first
+    lifo,          // Most recently removed id first
+    lowest_first,  // Lowest removed id first, keeping the live entities packed at the start of the id range
+};
+
+// Storage tags, selecting how a component type is stored
+struct dense_storage {};   // Indexed by entity id, best for common components
+struct sparse_storage {};  // Sparse set with packed arrays, best for rare components
+struct soa_storage {};     // Indexed by entity id with one array per field, listed by member pointers in the traits
+struct tag_storage {};     // Only a bit per entity id, the default for empty component types
+struct singleton_storage {};  // A single instance shared by the engine instead of one per entity, for global resources
+
+template <typename ComponentType> class soa_pointer;
+
+// Specialize to configure how a component type is handled by the ECS
+template <typename ComponentType>
+struct component_traits {};
+
+// Query filters, which can be mixed with component types when iterating
+template <typename... ComponentTypes> struct with {};      // Entities must have the components, which are not returned
+template <typename... ComponentTypes> struct without {};   // Entities must not have the components
+template <typename... ComponentTypes> struct optional {};  // Components are returned if present, and as a null pointer otherwise
+template <typename... ComponentTypes> struct changed {};   // Components must have changed since the given tick, which are not returned
+template <typename... ComponentTypes> struct added {};     // Components must have been added since the given tick, which are not returned
+
+namespace typing {
+
+template <typename ComponentType>
+struct storage_of {
+    using type = std::conditional_t<std::is_empty_v<ComponentType>, tag_storage, dense_storage>;
+};
+
+template <typename ComponentType>
+    requires requires { typename component_traits<ComponentType>::storage; }
+struct storage_of<ComponentType> {
+    using type = typename component_traits<ComponentType>::storage;
+};
+
+template <typename ComponentType>
+using storage_of_t = typename storage_of<std::remove_cv_t<ComponentType>>::type;
+
+template <typename ComponentType>
+inline constexpr bool is_sparse = std::is_same_v<storage_of_t<ComponentType>, sparse_storage>;
+
+template <typename ComponentType>
+inline constexpr bool is_tag = std::is_same_v<storage_of_t<ComponentType>, tag_storage>;
+
+template <typename ComponentType>
+inline constexpr bool is_singleton = std::is_same_v<storage_of_t<ComponentType>, singleton_storage>;
+
+template <typename ComponentType>
+inline constexpr bool is_soa = std::is_same_v<storage_of_t<ComponentType>, soa_storage>;
+
+template <typename MemberPointer> struct member_of;
+template <typename Class, typename Member>
+struct member_of<Member Class::*> {
+    using type = Member;
+};
+
+// Field arrays of a struct-of-arrays component, deduced from the member pointers in its traits
+template <typename ComponentType, typename Fields = std::remove_cvref_t<decltype(component_traits<ComponentType>::fields)>>
+struct fields_of;
+template <typename ComponentType, typename... MemberPointers>
+struct fields_of<ComponentType, std::tuple<MemberPointers...>> {
+    using arrays = std::tuple<std::pmr::vector<typename member_of<MemberPointers>::type>...>;
+    using spans  = std::tuple<std::span<typename member_of<MemberPointers>::type>...>;
+
+    static constexpr std::size_t count              = sizeof...(MemberPointers);
+    static constexpr bool        trivially_copyable = (std::is_trivially_copyable_v<typename member_of<MemberPointers>::type> && ...);
+};
+
+// Position of a member pointer in the fields of a struct-of-arrays component
+template <typename ComponentType, auto Field>
+constexpr std::size_t field_index() {
+    using fields      = std::remove_cvref_t<decltype(component_traits<ComponentType>::fields)>;
+    std::size_t index = SIZE_MAX;
+    [&]<std::size_t... Index>(std::index_sequence<Index...>) {
+        ([&] {
+            if constexpr (std::is_same_v<std::tuple_element_t<Index, fields>, decltype(Field)>) {
+                if (std::get<Index>(component_traits<ComponentType>::fields) == Field)
+                    index = Index;
+            }
+        }(),
+         ...);
+    }(std::make_index_sequence<std::tuple_size_v<fields>> {});
+    return index;
+}
+
+// Type returned when accessing a single component, struct-of-arrays components are accessed through a handle
+template <typename ComponentType>
+struct pointer_of {
+    using type = ComponentType*;
+};
+
+template <typename ComponentType>
+    requires is_soa<ComponentType>
+struct pointer_of<ComponentType> {
+    using type = soa_pointer<ComponentType>;
+};
+
+template <typename ComponentType>
+using pointer_t = typename pointer_of<ComponentType>::type;
+
+template <typename ComponentType>
+struct tracks_changes_of : std::false_type {};
+
+template <typename ComponentType>
+    requires requires { component_traits<ComponentType>::track_changes; }
+struct tracks_changes_of<ComponentType> : std::bool_constant<component_traits<ComponentType>::track_changes> {};
+
+template <typename ComponentType>
+inline constexpr bool tracks_changes = tracks_changes_of<std::remove_cv_t<ComponentType>>::value;
+
+// Component types with save and load functions in their traits are written to snapshots through these functions
+template <typename ComponentType>
+concept custom_snapshot = requires(std::ostream& out, std::istream& in, const ComponentType& component) {
+    component_traits<ComponentType>::save(out, component);
+    { component_traits<ComponentType>::load(in) } -> std::convertible_to<ComponentType>;
+};
+
+// Component types which are copied into snapshots byte for byte
+template <typename ComponentType>
+inline constexpr bool raw_snapshot = std::is_trivially_copyable_v<ComponentType> && !custom_snapshot<ComponentType>;
+
+// Compares two components by their representation in snapshots
+template <typename ComponentType>
+bool same_snapshot(const ComponentType& left, const ComponentType& right) {
+    if constexpr (raw_snapshot<ComponentType>) {
+        return std::memcmp(&left, &right, sizeof(ComponentType)) == 0;
+    } else {
+        std::ostringstream left_stream(std::ios::binary);
+        std::ostringstream right_stream(std::ios::binary);
+        component_traits<ComponentType>::save(left_stream, left);
+        component_traits<ComponentType>::save(right_stream, right);
+        return left_stream.view() == right_stream.view();
+    }
+}
+
+template <typename Tuple> inline constexpr bool any_sparse = false;
+template <typename... ComponentTypes>
+inline constexpr bool any_sparse<std::tuple<ComponentTypes...>> = (is_sparse<ComponentTypes> || ...);
+
+// Yields the same value once per type of a parameter pack expansion
+template <typename, typename Value>
+constexpr Value&& repeat(Value&& value) {
+    return std::forward<Value>(value);
+}
+
+// Calls a function template with the types of a tuple as template arguments
+template <typename Tuple> struct unpack;
+template <typename... Types>
+struct unpack<std::tuple<Types...>> {
+    template <typename Function>
+    static constexpr decltype(auto) apply(Function&& function) {
+        return function.template operator()<Types...>();
+    }
+};
+
+// Parameter types of a function or of the call operator of a function object
+template <typename Callable>
+struct callable_traits {};
+
+template <typename Callable>
+    requires requires { &Callable::operator(); }
+struct callable_traits<Callable> : callable_traits<decltype(&Callable::operator())> {};
+
+template <typename Result, typename... Args>
+struct callable_traits<Result(Args...)> {
+    using arguments = std::tuple<Args...>;
+};
+
+template <typename Result, typename... Args>
+struct callable_traits<Result(Args...) noexcept> : callable_traits<Result(Args...)> {};
+template <typename Result, typename... Args>
+struct callable_traits<Result (*)(Args...)> : callable_traits<Result(Args...)> {};
+template <typename Result, typename... Args>
+struct callable_traits<Result (*)(Args...) noexcept> : callable_traits<Result(Args...)> {};
+template <typename Class, typename Result, typename... Args>
+struct callable_traits<Result (Class::*)(Args...)> : callable_traits<Result(Args...)> {};
+template <typename Class, typename Result, typename... Args>
+struct callable_traits<Result (Class::*)(Args...) noexcept> : callable_traits<Result(Args...)> {};
+template <typename Class, typename Result, typename... Args>
+struct callable_traits<Result (Class::*)(Args...) const> : callable_traits<Result(Args...)> {};
+template <typename Class, typename Result, typename... Args>
+struct callable_traits<Result (Class::*)(Args...) const noexcept> : callable_traits<Result(Args...)> {};
+
+// Splits the parameters of a system into the optional engine and entity id, and the received components
+template <typename Engine, typename Arguments>
+struct system_signature {};
+
+template <typename Engine, typename... ComponentTypes>
+struct system_signature<Engine, std::tuple<ComponentTypes*...>> {
+    using components                  = std::tuple<ComponentTypes...>;
+    static constexpr bool with_engine = false;
+    static constexpr bool with_entity = false;
+};
+
+template <typename Engine, typename... ComponentTypes>
+struct system_signature<Engine, std::tuple<entity_id, ComponentTypes*...>> : system_signature<Engine, std::tuple<ComponentTypes*...>> {
+    static constexpr bool with_entity = true;
+};
+
+template <typename Engine, typename... ComponentTypes>
+struct system_signature<Engine, std::tuple<Engine&, ComponentTypes*...>> : system_signature<Engine, std::tuple<ComponentTypes*...>> {
+    static constexpr bool with_engine = true;
+};
+
+template <typename Engine, typename... ComponentTypes>
+struct system_signature<Engine, std::tuple<Engine&, entity_id, ComponentTypes*...>> : system_signature<Engine, std::tuple<ComponentTypes*...>> {
+    static constexpr bool with_engine = true;
+    static constexpr bool with_entity = true;
+};
+
+// Function objects with a single, non-template call operator receiving component pointers
+template <typename Engine, typename System>
+concept system_object = std::is_class_v<std::remove_cvref_t<System>> && requires {
+    typename system_signature<Engine, typename callable_traits<std::remove_cvref_t<System>>::arguments>::components;
+};
+
+// How a single requested type or filter contributes to a query
+struct empty_query_term {
+    using required   = std::tuple<>;
+    using excluded   = std::tuple<>;
+    using changed    = std::tuple<>;  // Components which must have changed since the tick of the query
+    using added      = std::tuple<>;  // Components which must have been added since the tick of the query
+    using returned   = std::tuple<>;
+    using singletons = std::tuple<>;  // Singleton components, which must be set but are not attached to entities
+};
+
+template <typename Term>
+struct query_term : empty_query_term {
+    using required = std::tuple<Term>;
+    using returned = std::tuple<Term*>;
+};
+
+template <typename Term>
+    requires is_singleton<Term>
+struct query_term<Term> : empty_query_term {
+    using returned   = std::tuple<Term*>;
+    using singletons = std::tuple<Term>;
+};
+
+template <typename... ComponentTypes>
+struct query_term<with<ComponentTypes...>> : empty_query_term {
+    using required = std::tuple<ComponentTypes...>;
+};
+
+template <typename... ComponentTypes>
+struct query_term<without<ComponentTypes...>> : empty_query_term {
+    using excluded = std::tuple<ComponentTypes...>;
+};
+
+template <typename... ComponentTypes>
+struct query_term<optional<ComponentTypes...>> : empty_query_term {
+    using returned = std::tuple<ComponentTypes*...>;
+};
+
+template <typename... ComponentTypes>
+struct query_term<changed<ComponentTypes...>> : empty_query_term {
+    using required = std::tuple<ComponentTypes...>;
+    using changed  = std::tuple<ComponentTypes...>;
+};
+
+template <typename... ComponentTypes>
+struct query_term<added<ComponentTypes...>> : empty_query_term {
+    using required = std::tuple<ComponentTypes...>;
+    using added    = std::tuple<ComponentTypes...>;
+};
+
+// Splits the requested types and filters of a query into the required, excluded and returned component types
+template <typename... Terms>
+struct query {
+    using required = decltype(std::tuple_cat(std::declval<typename query_term<Terms>::required>()...));
+    using excluded = decltype(std::tuple_cat(std::declval<typename query_term<Terms>::excluded>()...));
+    using changed  = decltype(std::tuple_cat(std::declval<typename query_term<Terms>::changed>()...));
+    using added    = decltype(std::tuple_cat(std::declval<typename query_term<Terms>::added>()...));
+    using returned   = decltype(std::tuple_cat(std::declval<typename query_term<Terms>::returned>()...));
+    using singletons = decltype(std::tuple_cat(std::declval<typename query_term<Terms>::singletons>()...));
+
+    static constexpr bool has_ticks   = std::tuple_size_v<changed> + std::tuple_size_v<added> > 0;
+    static constexpr bool returns_soa = unpack<returned>::apply([]<typename... Types>() {
+        return (is_soa<std::remove_pointer_t<Types>> || ...);
+    });
+
+    template <typename... RegisteredComponents>
+    static constexpr bool is_registered = unpack<decltype(std::tuple_cat(std::declval<required>(), std::declval<excluded>(), std::declval<returned>()))>::apply([]<typename... Types>() {
+        return (is_one_of<std::remove_const_t<std::remove_pointer_t<Types>>, RegisteredComponents...> && ...);
+    });
+};
+
+}  // namespace typing
+
+class bitset {
+   private:
+    std::pmr::vector<std::uint64_t> _words;
+    std::pmr::vector<std::uint64_t> _summary;  // One bit per word, set if the word has any bit set
+    std::size_t                     _size = 0;
+
+   public:
+    static constexpr std::size_t word_bits = 64;
+
+    explicit bitset(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    ~bitset();
+
+    bool        test(std::size_t index) const;
+    void        set(std::size_t index);
+    void        reset(std::size_t index);
+    void        resize(std::size_t new_size);
+    void        assign(const void* words, std::size_t size);  // Replaces all bits with size bits copied from raw words
+    void        push_back(bool value);
+    std::size_t size() const;
+    std::size_t count() const;
+
+    std::size_t find_next(std::size_t from) const;
+    std::size_t find_last() const;
+
+    const std::uint64_t* words() const;
+    std::size_t          word_count() const;
+    std::size_t          reserved_bytes() const;
+    void                 shrink_to_fit();
+
+    template <std::size_t Count>
+    static std::size_t find_next_common(const std::array<const bitset*, Count>& sets, std::size_t from);
+};
+
+// Unordered set of entity ids, with constant time insertion and removal and contiguous iteration
+class entity_set {
+   private:
+    static constexpr std::size_t absent = SIZE_MAX;
+
+    std::vector<std::size_t> _positions;  // Index in the packed entity ids per entity id
+    std::vector<entity_id>   _entities;   // Packed entity ids
+
+   public:
+    entity_set();
+    ~entity_set();
+
+    bool                       contains(entity_id entity) const;
+    bool                       insert(entity_id entity);
+    bool                       erase(entity_id entity);
+    void                       clear();
+    std::size_t                size() const;
+    std::span<const entity_id> entities() const;
+};
+
+// Sequential writer of binary snapshots, arrays are padded to 8 bytes so that a mapped snapshot can be copied from directly
+class snapshot_writer {
+   private:
+    std::ostream& _out;
+    std::size_t   _offset = 0;
+
+   public:
+    static constexpr std::size_t alignment = 8;
+
+    explicit snapshot_writer(std::ostream& out);
+
+    template <typename Value> void value(const Value& value);
+    template <typename Function> void blob(Function&& function);  // Array of the bytes written to the stream by the function
+    template <typename ComponentType, typename Function> void components(std::size_t count, Function&& component);  // Components returned by the function per index, raw or through their traits
+
+    void write(const void* data, std::size_t size);
+    void zeros(std::size_t size);
+    void align();
+    void array(const void* data, std::size_t size);  // Size in bytes, followed by the aligned bytes
+    void bits(const bitset& set, std::size_t size);  // First size bits of the set, followed by the aligned words
+    bool good() const;
+};
+
+// Sequential reader of binary snapshots, every read fails once the data is exhausted
+class snapshot_reader {
+   private:
+    // Read-only stream buffer over the bytes of a blob, for the load functions of component traits
+    struct blob_buffer : std::streambuf {
+        explicit blob_buffer(std::span<const std::byte> bytes);
+    };
+
+    std::span<const std::byte> _data;
+    std::size_t                _offset = 0;
+    bool                       _failed = false;
+
+   public:
+    explicit snapshot_reader(std::span<const std::byte> data);
+
+    template <typename Value> Value              value();  // Value-initialized when the read failed
+    template <typename Value> std::vector<Value> values();  // Array of values, empty when the read failed
+    template <typename Function> bool            blob(Function&& function);
+    template <typename ComponentType, typename Function> bool components(std::size_t count, Function&& function);  // Passes the index and the component to the function
+
+    std::span<const std::byte> read(std::size_t size);  // Empty when the read failed
+    void                       align();
+    std::span<const std::byte> array();
+    bool                       bits(bitset& set);
+    bool                       failed() const;
+};
+
+// Operations on a component list, only counted when profiling
+struct list_counters {
+    std::size_t adds           = 0;
+    std::size_t removes        = 0;
+    std::size_t resizes        = 0;  // Reallocations of the component storage
+    std::size_t reserved_bytes = 0;  // Memory currently held by the component list
+};
+
+struct system_profile {
+    std::string   name;
+    std::size_t   runs     = 0;
+    std::size_t   entities = 0;  // Entities visited over all runs
+    std::uint64_t total_ns = 0;  // Wall time of all runs
+    std::uint64_t query_ns = 0;  // Time spent finding the matching entities, summed over all threads
+};
+
+struct component_profile {
+    std::string   name;
+    std::size_t   count = 0;  // Amount of components
+    list_counters counters;
+};
+
+struct profile_report {
+    std::vector<system_profile>    systems;     // In order of their first run or name
+    std::vector<component_profile> components;  // In order of registration
+};
+
+// Memory held by a component list
+struct component_memory {
+    std::string name;
+    std::size_t capacity  = 0;    // Component slots held by the list
+    std::size_t count     = 0;    // Slots holding a component
+    double      occupancy = 0.0;  // Count relative to capacity, zero for lists without storage
+    std::size_t bytes     = 0;
+};
+
+struct memory_report {
+    std::vector<component_memory> components;           // In order of registration
+    std::size_t                   entities        = 0;  // Alive entities
+    std::size_t                   entity_capacity = 0;  // Entity ids in use or free to be reused
+    std::size_t                   free_entities   = 0;  // Freed entity ids waiting to be reused
+    std::size_t                   entity_bytes    = 0;  // Held by the bitset of entities
+    std::size_t                   free_used_bytes = 0;  // Used by the freed entity ids, the storage held by the queue can't be queried
+    std::size_t                   bytes           = 0;  // Total of the entities, the freed entity ids and all component lists
+};
+
+// Records the runs of systems, every run and every parallel chunk is kept as an event for traces
+class profiler {
+   public:
+    using clock = std::chrono::steady_clock;
+
+    // Systems are identified by the address of their function, or by the type of their function object
+    struct system_id {
+        std::uintptr_t   key = 0;
+        std::string_view type;
+    };
+
+    // Times a run of a system, or a part of a parallel run
+    class scope {
+       private:
+        profiler*         _profiler;
+        system_id         _system;
+        bool              _run;
+        clock::time_point _start;
+        clock::duration   _query {};
+        std::size_t       _entities = 0;
+
+       public:
+        scope(profiler& profiler, const system_id& system, bool run = true);
+        ~scope();
+        scope(const scope&)            = delete;
+        scope& operator=(const scope&) = delete;
+
+        template <typename Function> decltype(auto) query(Function&& function);  // Runs the function, timed as query matching
+        void                                        visit(std::size_t entities = 1);
+    };
+
+    profiler();
+
+    template <typename System> static system_id identify(const System& system);
+
+    void                        name(const system_id& system, std::string name);
+    std::vector<system_profile> systems() const;
+    void                        reset();
+    void                        write_trace(std::ostream& out, const std::vector<component_profile>& components) const;
+
+   private:
+    struct event {
+        std::size_t       system;  // Index in the system profiles
+        clock::time_point start;
+        clock::duration   duration;
+        std::size_t       thread;
+    };
+
+    mutable std::mutex                                _mutex;
+    clock::time_point                                 _epoch;
+    std::vector<system_profile>                       _systems;
+    std::unordered_map<std::uintptr_t, std::size_t>   _indices;  // Index in the system profiles per system key
+    std::unordered_map<std::thread::id, std::size_t>  _threads;
+    std::vector<event>                                _events;
+
+    std::size_t _index_of(const system_id& system);
+    void        _record(const system_id& system, bool run, clock::time_point start, clock::duration query, std::size_t entities);
+};
+
+// Empty stand-in for the profiler when NEAT_ECS_PROFILE is not defined, so that the instrumentation compiles away
+class null_profiler {
+   public:
+    struct system_id {};
+
+    class scope {
+       public:
+        scope(null_profiler&, const system_id&, bool = true) {}
+
+        template <typename Function> decltype(auto) query(Function&& function) { return function(); }
+        void                                        visit(std::size_t = 1) {}
+    };
+
+    template <typename System> static system_id identify(const System&) { return {}; }
+
+    void                        name(const system_id&, std::string) {}
+    std::vector<system_profile> systems() const { return {}; }
+    void                        reset() {}
+    void                        write_trace(std::ostream& out, const std::vector<component_profile>&) const { out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[]}"; }
+};
+
+using active_profiler = std::conditional_t<profiling, profiler, null_profiler>;
+
+class thread_pool {
+   private:
+    struct job {
+        const std::function<void(std::size_t, std::size_t)>& function;
+        std::atomic<std::size_t>                              remaining;
+        std::exception_ptr                                    error;
+        std::mutex                                            error_mutex;
+    };
+
+    struct task {
+        job*        owner;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    struct queue {
+        std::mutex       mutex;
+        std::deque<task> tasks;
+    };
+
+    std::vector<std::thread> _threads;
+    std::unique_ptr<queue[]> _queues;  // One queue per worker thread, tasks are stolen from other queues when empty
+    std::size_t              _queue_count;
+    std::atomic<std::size_t> _pending = 0;
+    std::mutex               _mutex;
+    std::condition_variable  _condition;
+    bool                     _stopping = false;
+
+    static inline thread_local const thread_pool* _current_pool  = nullptr;
+    static inline thread_local std::size_t        _current_queue = 0;
+
+    void _work(std::size_t index);
+    bool _run_one(std::size_t preferred);
+
+   public:
+    explicit thread_pool(std::size_t thread_count = std::thread::hardware_concurrency());
+    ~thread_pool();
+    thread_pool(const thread_pool&)            = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    std::size_t thread_count() const;
+    std::size_t thread_index() const;
+    void        parallel_for(std::size_t begin, std::size_t end, std::size_t grain_size, const std::function<void(std::size_t, std::size_t)>& function);
+};
+
+// Every storage provides the interface of the dense list
+template <typename ComponentType, typename Storage = typing::storage_of_t<ComponentType>>
+class componentlist;
+
+template <typename ComponentType>
+class componentlist<ComponentType, dense_storage> {
+   private:
+    using allocator_type   = std::pmr::polymorphic_allocator<ComponentType>;
+    using allocator_traits = std::allocator_traits<allocator_type>;
+
+    bitset                      _tags;
+    allocator_type              _allocator;
+    ComponentType*              _components = nullptr;  // Uninitialized storage, only the slots of entities with the component hold an object
+    std::size_t                 _capacity   = 0;
+    std::size_t                 _count      = 0;  // Amount of entities with the component
+    std::pmr::vector<tick_type> _added_ticks;     // Tick at which the component was added per entity, if changes are tracked
+    std::pmr::vector<tick_type> _changed_ticks;   // Tick at which the component was last changed per entity, if changes are tracked
+    list_counters               _counters;
+
+    void _reserve(std::size_t new_capacity);
+    void _reallocate(std::size_t new_capacity);
+
+    template <typename... Args>
+    ComponentType* _construct(entity_id entity, Args&&... args);
+
+   public:
+    explicit componentlist(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    ~componentlist();
+    componentlist(const componentlist&)            = delete;
+    componentlist& operator=(const componentlist&) = delete;
+
+    template <typename... Args>
+    ComponentType* add(entity_id entity, Args&&... args);
+    ComponentType* get(entity_id entity);
+
+    bool has(entity_id entity) const;
+    bool remove(entity_id entity);
+    bool allocate(size_t new_count);
+    void compact(std::span<const entity_id> remap, std::size_t count);  // Moves components to their remapped entity ids, and shrinks to count ids
+    void shrink_to_fit();                                               // Releases the storage past the last entity with the component
+    void clear();
+    void save(snapshot_writer& out) const;
+    bool restore(snapshot_reader& in, std::size_t capacity);  // Replaces all components, only entity ids below the capacity are accepted
+    void diff(const componentlist& base, const bitset& alive, snapshot_writer& out) const;  // Changes since base, skipping entities which are no longer alive
+    bool apply(snapshot_reader& in, std::size_t capacity, std::vector<entity_id>& touched);  // Applies the changes written by diff, collecting the changed entities
+
+    std::tuple<entity_id, ComponentType*> first();
+    std::size_t                           size() const;
+    const bitset&                         tags() const;
+    std::size_t                           capacity() const;  // Amount of component slots held
+    list_counters                         counters() const;
+
+    void      set_added(entity_id entity, tick_type tick);
+    void      set_changed(entity_id entity, tick_type tick);
+    tick_type added_tick(entity_id entity) const;
+    tick_type changed_tick(entity_id entity) const;
+};
+
+template <typename ComponentType>
+class componentlist<ComponentType, sparse_storage> {
+   private:
+    static constexpr std::size_t absent = SIZE_MAX;
+
+    std::pmr::vector<std::size_t>   _sparse;         // Index in the packed arrays per entity id
+    std::pmr::vector<entity_id>     _entities;       // Packed entity ids
+    std::pmr::vector<ComponentType> _components;     // Packed components, in the same order as the entity ids
+    std::pmr::vector<tick_type>     _added_ticks;    // Packed added ticks, if changes are tracked
+    std::pmr::vector<tick_type>     _changed_ticks;  // Packed changed ticks, if changes are tracked
+    list_counters                   _counters;
+
+    template <typename... Args>
+    ComponentType* _push(entity_id entity, Args&&... args);
+
+   public:
+    explicit componentlist(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    ~componentlist();
+
+    template <typename... Args>
+    ComponentType* add(entity_id entity, Args&&... args);
+    ComponentType* get(entity_id entity);
+
+    bool has(entity_id entity) const;
+    bool remove(entity_id entity);
+    bool allocate(size_t new_count);
+    void compact(std::span<const entity_id> remap, std::size_t count);
+    void shrink_to_fit();
+    void clear();
+    void save(snapshot_writer& out) const;
+    bool restore(snapshot_reader& in, std::size_t capacity);
+    void diff(const componentlist& base, const bitset& alive, snapshot_writer& out) const;
+    bool apply(snapshot_reader& in, std::size_t capacity, std::vector<entity_id>& touched);
+
+    std::tuple<entity_id, ComponentType*> first();
+    std::size_t                           size() const;
+    std::span<const entity_id>            entities() const;
+    std::span<ComponentType>              components();
+    std::size_t                           capacity() const;
+    list_counters                         counters() const;
+
+    void      set_added(entity_id entity, tick_type tick);
+    void      set_changed(entity_id entity, tick_type tick);
+    tick_type added_tick(entity_id entity) const;
+    tick_type changed_tick(entity_id entity) const;
+};
+
+template <typename ComponentType>
+class componentlist<ComponentType, tag_storage> {
+   private:
+    static inline ComponentType _instance {};  // Empty components hold no state, so all entities share a single object
+
+    bitset        _tags;
+    std::size_t   _count = 0;  // Amount of entities with the component
+    list_counters _counters;
+
+   public:
+    explicit componentlist(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    ~componentlist();
+
+    template <typename... Args>
+    ComponentType* add(entity_id entity, Args&&... args);
+    ComponentType* get(entity_id entity);
+
+    bool has(entity_id entity) const;
+    bool remove(entity_id entity);
+    bool allocate(size_t new_count);
+    void compact(std::span<const entity_id> remap, std::size_t count);
+    void shrink_to_fit();
+    void clear();
+    void save(snapshot_writer& out) const;
+    bool restore(snapshot_reader& in, std::size_t capacity);
+    void diff(const componentlist& base, const bitset& alive, snapshot_writer& out) const;
+    bool apply(snapshot_reader& in, std::size_t capacity, std::vector<entity_id>& touched);
+
+    std::tuple<entity_id, ComponentType*> first();
+    std::size_t                           size() const;
+    const bitset&                         tags() const;
+    std::size_t                           capacity() const;
+    list_counters                         counters() const;
+};
+
+template <typename ComponentType>
+class componentlist<ComponentType, singleton_storage> {
+   private:
+    std::optional<ComponentType> _value;
+    list_counters                _counters;
+
+   public:
+    explicit componentlist(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    ~componentlist();
+
+    template <typename... Args>
+    ComponentType* set(Args&&... args);
+    ComponentType* get();
+    ComponentType* get(entity_id entity);  // The instance is shared by all entities
+
+    bool has(entity_id entity) const;  // Singletons are never attached to entities
+    bool remove(entity_id entity);
+    bool reset();
+    bool allocate(size_t new_count);
+    void compact(std::span<const entity_id> remap, std::size_t count);
+    void shrink_to_fit();
+    void clear();
+    void save(snapshot_writer& out) const;
+    bool restore(snapshot_reader& in, std::size_t capacity);
+    void diff(const componentlist& base, const bitset& alive, snapshot_writer& out) const;
+    bool apply(snapshot_reader& in, std::size_t capacity, std::vector<entity_id>& touched);
+
+    std::size_t   size() const;
+    std::size_t   capacity() const;
+    list_counters counters() const;
+};
+
+template <typename ComponentType>
+class componentlist<ComponentType, soa_storage> {
+   private:
+    friend class soa_pointer<ComponentType>;
+    friend class soa_pointer<const ComponentType>;
+
+    using fields_type = typing::fields_of<ComponentType>;
+
+    static constexpr auto _members = component_traits<ComponentType>::fields;
+
+    bitset                       _tags;
+    typename fields_type::arrays _fields;     // One array per field indexed by entity id, slots without a component hold value-initialized fields
+    std::size_t                  _count = 0;  // Amount of entities with the component
+    list_counters                _counters;
+
+    template <typename Function> static void _for_each_field(Function&& function);
+
+   public:
+    explicit componentlist(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    ~componentlist();
+
+    template <typename... Args>
+    soa_pointer<ComponentType> add(entity_id entity, Args&&... args);
+    soa_pointer<ComponentType> get(entity_id entity);
+
+    bool has(entity_id entity) const;
+    bool remove(entity_id entity);
+    bool allocate(size_t new_count);
+    void compact(std::span<const entity_id> remap, std::size_t count);
+    void shrink_to_fit();
+    void clear();
+    void save(snapshot_writer& out) const;
+    bool restore(snapshot_reader& in, std::size_t capacity);
+    void diff(const componentlist& base, const bitset& alive, snapshot_writer& out) const;
+    bool apply(snapshot_reader& in, std::size_t capacity, std::vector<entity_id>& touched);
+
+    std::tuple<entity_id, soa_pointer<ComponentType>> first();
+    std::size_t                                       size() const;
+    const bitset&                                     tags() const;
+    typename fields_type::spans                       fields();
+    std::size_t                                       capacity() const;
+    list_counters                                     counters() const;
+
+    ComponentType load(entity_id entity) const;
+    void          store(entity_id entity, ComponentType&& value);
+};
+
+// Pointer-like handle to a struct-of-arrays component, of which the fields are spread over separate arrays
+template <typename ComponentType>
+class soa_pointer {
+   private:
+    template <typename> friend class soa_pointer;
+    using list_type = componentlist<std::remove_const_t<ComponentType>, soa_storage>;
+
+    list_type* _list   = nullptr;
+    entity_id  _entity = invalid_entity;
+
+   public:
+    soa_pointer() = default;
+    soa_pointer(std::nullptr_t);
+    soa_pointer(list_type* list, entity_id entity);
+    template <typename OtherComponent>
+        requires std::is_same_v<const OtherComponent, ComponentType>
+    soa_pointer(const soa_pointer<OtherComponent>& other);
+
+    template <auto Field> decltype(auto) get() const;
+    std::remove_const_t<ComponentType>   load() const;
+    void                                 store(std::remove_const_t<ComponentType> value) const
+        requires(!std::is_const_v<ComponentType>);
+
+    entity_id entity() const;
+    explicit  operator bool() const;
+    bool      operator==(std::nullptr_t) const;
+};
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+class view : public std::ranges::view_interface<view<Engine, WithEntity, RequestedComponents...>> {
+   public:
+    class iterator;
+
+    view() = default;
+    explicit view(Engine& ecs, tick_type since = 0);
+
+    iterator begin() const;
+    iterator end() const;
+
+   private:
+    friend Engine;
+
+    using query    = typing::query<RequestedComponents...>;
+    using required = typename query::required;
+    using excluded = typename query::excluded;
+
+    static_assert(!query::returns_soa, "Struct-of-arrays components can not be returned by a query, use components.fields instead.");
+
+    Engine*     _ecs   = nullptr;
+    std::size_t _first = 0;         // Start of the cursor range
+    std::size_t _last  = SIZE_MAX;  // End of the cursor range
+    tick_type   _since = 0;         // Tick used by the changed and added filters
+
+    view(Engine& ecs, std::size_t first, std::size_t last);
+
+    iterator    _make_iterator(bool at_end) const;
+    std::size_t _cursor_end() const;
+};
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+class view<Engine, WithEntity, RequestedComponents...>::iterator {
+   public:
+    using value_type        = std::conditional_t<WithEntity, decltype(std::tuple_cat(std::declval<std::tuple<entity_id>>(), std::declval<typename query::returned>())), typename query::returned>;
+    using difference_type   = std::ptrdiff_t;
+    using iterator_concept  = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+
+    iterator() = default;
+    iterator(Engine* ecs, const entity_id* packed, const bitset* tags, std::size_t driver, std::size_t cursor, std::size_t end, tick_type since);
+
+    value_type operator*() const;
+    iterator&  operator++();
+    iterator   operator++(int);
+    bool       operator==(const iterator& other) const;
+
+   private:
+    friend class view;
+
+    Engine*          _ecs    = nullptr;
+    const entity_id* _packed = nullptr;         // Packed entity ids of the sparse driver, if any
+    const bitset*    _tags   = nullptr;         // Tags of the dense driver, if any
+    std::size_t      _driver = SIZE_MAX;        // Index of the driving component in the requested components
+    std::size_t      _cursor = 0;               // Entity id, or index in the packed entity ids
+    std::size_t      _end    = 0;               // End of the cursor range
+    entity_id        _entity = invalid_entity;  // Current entity
+    tick_type        _since  = 0;
+
+    void                                                       _skip_to_match();
+    bool                                                       _matches(entity_id entity) const;
+    bool                                                       _is_filtered(entity_id entity) const;
+    template <typename RequestedComponent> RequestedComponent* _get_component() const;
+};
+
+template <typename Engine, typename... RequestedComponents>
+class cached_query : public std::ranges::view_interface<cached_query<Engine, RequestedComponents...>> {
+   public:
+    class iterator;
+
+    cached_query() = default;
+    cached_query(cached_query&& other) noexcept = default;
+    cached_query& operator=(cached_query&& other) noexcept;
+    ~cached_query();
+
+    iterator                   begin() const;
+    iterator                   end() const;
+    std::size_t                size() const;
+    std::span<const entity_id> entities() const;
+
+   private:
+    friend Engine;
+
+    std::unique_ptr<typename Engine::query_state> _state;
+
+    explicit cached_query(Engine& ecs);
+    void _unregister();
+};
+
+template <typename Engine, typename... RequestedComponents>
+class cached_query<Engine, RequestedComponents...>::iterator {
+   public:
+    using value_type        = std::tuple<entity_id, RequestedComponents*...>;
+    using difference_type   = std::ptrdiff_t;
+    using iterator_concept  = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+
+    iterator() = default;
+    iterator(Engine* ecs, const entity_id* entities, std::size_t index);
+
+    value_type operator*() const;
+    iterator&  operator++();
+    iterator   operator++(int);
+    bool       operator==(const iterator& other) const;
+
+   private:
+    Engine*          _ecs      = nullptr;
+    const entity_id* _entities = nullptr;
+    std::size_t      _index    = 0;
+};
+
+template <typename... RegisteredComponents>
+class engine {
+   private:
+    class entities;
+    class components;
+    class systems;
+    class scheduler;
+
+   public:
+    class command_buffer;
+
+    explicit engine(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    ~engine();
+
+    template <typename... RequestedComponents> view<engine, true, RequestedComponents...>  iterate(tick_type since = 0);
+    template <typename... RequestedComponents> view<engine, false, RequestedComponents...> iterate_components(tick_type since = 0);
+    template <typename... RequestedComponents> cached_query<engine, RequestedComponents...> cache();
+
+    void      flush(command_buffer& buffer);
+    tick_type current_tick() const;
+    tick_type advance_tick();
+
+    void save(std::ostream& out) const;
+    bool restore(std::istream& in);
+    bool restore(std::span<const std::byte> snapshot);  // Leaves the engine untouched on a mismatching header, and empty on corrupt data
+
+    memory_report memory_stats() const;
+    void          shrink_to_fit();  // Releases the storage of every component list past the last entity with the component
+
+    profile_report profile() const;  // Empty unless NEAT_ECS_PROFILE is defined
+    void           reset_profile();
+    void           write_trace(std::ostream& out) const;  // Chrome trace event JSON of the recorded system runs
+
+    void delta(const engine& base, std::ostream& out) const;  // Changes from the state of base to the state of this engine
+    bool delta(std::span<const std::byte> base_snapshot, std::ostream& out) const;
+    bool apply(std::istream& in);
+    bool apply(std::span<const std::byte> delta);  // Leaves the engine untouched on a mismatching header or entities, and empty on corrupt data
+
+    entities   entities;
+    components components;
+    systems    systems;
+    scheduler  scheduler;
+
+   private:
+    template <typename, bool, typename...> friend class view;
+    template <typename, typename...> friend class cached_query;
+
+    // Matching entities of a cached query, kept up to date when components and entities are added or removed
+    struct query_state {
+        engine*                                      ecs;
+        entity_set                                   entities;
+        std::bitset<sizeof...(RegisteredComponents)> components;  // Components required by the query
+        bool (*matches)(engine& ecs, entity_id entity);
+    };
+
+    std::pmr::vector<query_state*> _queries;
+    tick_type                      _tick = 1;
+
+    [[no_unique_address]] active_profiler _profiler;  // Empty unless NEAT_ECS_PROFILE is defined
+
+    static constexpr char          _snapshot_magic[8] = {'N', 'E', 'A', 'T', 'E', 'C', 'S', '\0'};
+    static constexpr char          _delta_magic[8]    = {'N', 'E', 'A', 'T', 'D', 'L', 'T', '\0'};
+    static constexpr std::uint32_t _snapshot_version  = 2;
+
+    template <typename RequestedComponent> static std::uint64_t           _snapshot_signature();
+    void                                                                  _write_header(snapshot_writer& writer, const char (&magic)[8]) const;
+    bool                                                                  _read_header(snapshot_reader& reader, const char (&magic)[8]) const;
+    void                                                                  _clear();
+
+    template <typename RequestedComponent> static constexpr std::size_t _index_of();
+    template <typename... RequestedComponents> static bool              _matches(engine& ecs, entity_id entity);
+    template <typename RequestedComponent> void                         _on_component_added(entity_id entity);
+    template <typename RequestedComponent> void                         _on_component_removed(entity_id entity);
+    void                                                                _on_entity_created(entity_id entity);
+    void                                                                _on_entity_removed(entity_id entity);
+    template <typename RequestedComponent> void                         _flush_commands(command_buffer& buffer, const std::vector<entity_id>& created);
+    template <typename... RequestedComponents> void                     _mark_written(entity_id entity);
+
+    entity_id                                                                                      _entity_capacity() const;
+    template <typename RequestedComponent> componentlist<std::remove_const_t<RequestedComponent>>& _get_components_list();
+    template <typename RequestedComponent> void                                                    _grow_components(entity_id last);
+    template <typename... RequestedComponents> bool                                                _entity_has_components(entity_id entity);
+    template <typename... RequestedComponents> entity_id                                           _find_next_entity_with_components(entity_id from);
+
+   private:
+    class entities final {
+       private:
+        friend class engine;
+        engine&                    _ecs;
+        bitset                     _entities;
+        std::pmr::deque<entity_id> _free_entities;  // Ordered by the reuse policy, a min-heap for lowest_first
+        reuse_policy               _policy = reuse_policy::fifo;
+        entities(engine& e, std::pmr::memory_resource* resource);
+
+        void      _push_free(entity_id entity);
+        entity_id _pop_free();
+        void      _sift_up(std::size_t index);
+        void      _sift_down(std::size_t index);
+
+       public:
+        entity_id              create();
+        std::vector<entity_id> create_many(std::size_t count);
+        bool                   remove(entity_id entity);
+        std::size_t            remove_many(std::span<const entity_id> entity_list);
+        bool                   exists(entity_id entity) const;
+        entity_id              last() const;
+        std::vector<entity_id> all() const;
+
+        void                   set_reuse_policy(reuse_policy policy);
+        reuse_policy           policy() const;
+        std::vector<entity_id> compact();
+    };
+
+    class components final {
+       private:
+        friend class engine;
+        engine&                                            _ecs;
+        std::tuple<componentlist<RegisteredComponents>...> _components;
+        components(engine& e, std::pmr::memory_resource* resource);
+
+       public:
+        template <typename RequestedComponent> typing::pointer_t<RequestedComponent>                   get(entity_id entity);
+        template <typename RequestedComponent> std::vector<typing::pointer_t<RequestedComponent>>      get(const std::vector<entity_id>& entity_list);
+        template <typename RequestedComponent, typename... Args> typing::pointer_t<RequestedComponent> add(entity_id entity, Args&&... args);
+        template <typename RequestedComponent, typename... Args> std::size_t                           add_many(std::span<const entity_id> entity_list, const Args&... args);
+
+        template <typename RequestedComponent> bool has(entity_id entity) const;
+        template <typename RequestedComponent> bool remove(entity_id entity);
+        template <typename RequestedComponent> bool allocate(size_t new_size);
+        bool                                        allocate_all(size_t new_size);
+
+        template <typename RequestedComponent> std::tuple<entity_id, typing::pointer_t<RequestedComponent>> first();
+        template <typename RequestedComponent> typename typing::fields_of<RequestedComponent>::spans        fields();
+
+        template <typename RequestedComponent, typename... Args> RequestedComponent* set(Args&&... args);
+        template <typename RequestedComponent> RequestedComponent*                   get();
+        template <typename RequestedComponent> bool                                  remove();
+    };
+
+    class systems final {
+       private:
+        friend class engine;
+        engine& _ecs;
+        explicit systems(engine& e);
+
+       public:
+        template <typename... FuncComponents> void execute(void (&system)(FuncComponents*...));
+        template <typename... FuncComponents> void execute(void (&system)(entity_id, FuncComponents*...));
+        template <typename... FuncComponents> void execute(void (&system)(engine<RegisteredComponents...>&, FuncComponents*...));
+        template <typename... FuncComponents> void execute(void (&system)(engine<RegisteredComponents...>&, entity_id, FuncComponents*...));
+
+        template <typename... FuncComponents> void execute_parallel(thread_pool& pool, void (&system)(FuncComponents*...), std::size_t grain_size = 1024);
+        template <typename... FuncComponents> void execute_parallel(thread_pool& pool, void (&system)(entity_id, FuncComponents*...), std::size_t grain_size = 1024);
+        template <typename... FuncComponents> void execute_parallel(thread_pool& pool, void (&system)(engine<RegisteredComponents...>&, FuncComponents*...), std::size_t grain_size = 1024);
+        template <typename... FuncComponents> void execute_parallel(thread_pool& pool, void (&system)(engine<RegisteredComponents...>&, entity_id, FuncComponents*...), std::size_t grain_size = 1024);
+
+        template <typename System> requires typing::system_object<engine, System> void execute(System&& system);
+        template <typename System> requires typing::system_object<engine, System> void execute_parallel(thread_pool& pool, System&& system, std::size_t grain_size = 1024);
+
+        template <typename... FuncComponents> void execute_batched(void (&system)(std::span<const entity_id>, std::span<FuncComponents>...), std::size_t batch_size = 1024);
+        template <typename... FuncComponents> void execute_batched_parallel(thread_pool& pool, void (&system)(std::span<const entity_id>, std::span<FuncComponents>...), std::size_t grain_size = 1024);
+
+        template <typename System> void name(const System& system, std::string name);  // Name of the system in profiles and traces
+
+       private:
+        template <bool WithEntity, typename... FuncComponents, typename System>
+        void _execute(const active_profiler::system_id& id, System&& system);
+        template <bool WithEntity, typename... FuncComponents, typename System>
+        void _execute_parallel(const active_profiler::system_id& id, thread_pool& pool, std::size_t grain_size, System&& system);
+        template <bool WithEntity, typename... FuncComponents, typename System>
+        void _invoke(System& system, const std::tuple<entity_id, FuncComponents*...>& data);
+        template <typename... FuncComponents, typename System>
+        void _execute_batched(active_profiler::scope& scope, entity_id first, entity_id last, std::size_t batch_size, System& system);
+    };
+
+    class scheduler final {
+       private:
+        friend class engine;
+        using access = std::bitset<sizeof...(RegisteredComponents)>;
+
+        struct scheduled_system {
+            std::function<void()> run;
+            access                reads;
+            access                writes;
+            bool                  exclusive;  // Systems which receive the engine can access anything
+        };
+
+        engine&                               _ecs;
+        std::vector<scheduled_system>         _systems;
+        std::vector<std::vector<std::size_t>> _stages;
+        bool                                  _dirty = false;
+        explicit scheduler(engine& e);
+
+        template <bool Exclusive, typename... FuncComponents> std::size_t _add(std::function<void()> run);
+        bool                                                              _conflicts(const scheduled_system& first, const scheduled_system& second) const;
+
+       public:
+        template <typename... FuncComponents> std::size_t add(void (&system)(FuncComponents*...));
+        template <typename... FuncComponents> std::size_t add(void (&system)(entity_id, FuncComponents*...));
+        template <typename... FuncComponents> std::size_t add(void (&system)(engine<RegisteredComponents...>&, FuncComponents*...));
+        template <typename... FuncComponents> std::size_t add(void (&system)(engine<RegisteredComponents...>&, entity_id, FuncComponents*...));
+        template <typename System> requires typing::system_object<engine, System> std::size_t add(System&& system);
+
+        void                                         run(thread_pool& pool);
+        std::size_t                                  size() const;
+        const std::vector<std::vector<std::size_t>>& schedule();
+    };
+   public:
+    // Records entity and component creations and removals, which are applied together when flushed into the engine
+    class command_buffer final {
+       private:
+        friend class engine;
+
+        static constexpr entity_id provisional = entity_id(1) << (sizeof(entity_id) * 8 - 1);  // Marks the ids of entities created by the buffer
+
+        template <typename ComponentType>
+        struct command_type {
+            entity_id                    entity;
+            std::optional<ComponentType> component;  // Empty if the component is removed
+        };
+
+        std::size_t                                                    _created = 0;
+        std::vector<entity_id>                                         _removed;
+        std::tuple<std::vector<command_type<RegisteredComponents>>...> _commands;
+
+        static entity_id _resolve(entity_id entity, const std::vector<entity_id>& created);  // Returns invalid_entity for unknown provisional ids
+
+       public:
+        command_buffer();
+        ~command_buffer();
+
+        entity_id                                                     create();
+        void                                                          remove(entity_id entity);
+        template <typename RequestedComponent, typename... Args> void add(entity_id entity, Args&&... args);
+        template <typename RequestedComponent> void                   remove(entity_id entity);
+
+        void merge(command_buffer&& other);
+        void clear();
+        bool empty() const;
+    };
+};
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+class archetype_view : public std::ranges::view_interface<archetype_view<Engine, WithEntity, RequestedComponents...>> {
+   public:
+    class iterator;
+
+    archetype_view() = default;
+    explicit archetype_view(Engine& ecs);
+
+    iterator begin() const;
+    iterator end() const;
+
+   private:
+    using query = typing::query<RequestedComponents...>;
+
+    Engine* _ecs = nullptr;
+};
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+class archetype_view<Engine, WithEntity, RequestedComponents...>::iterator {
+   public:
+    using value_type        = std::conditional_t<WithEntity, decltype(std::tuple_cat(std::declval<std::tuple<entity_id>>(), std::declval<typename query::returned>())), typename query::returned>;
+    using difference_type   = std::ptrdiff_t;
+    using iterator_concept  = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+
+    iterator() = default;
+    iterator(Engine* ecs, std::size_t archetype);
+
+    value_type operator*() const;
+    iterator&  operator++();
+    iterator   operator++(int);
+    bool       operator==(const iterator& other) const;
+
+   private:
+    Engine*     _ecs       = nullptr;
+    std::size_t _archetype = 0;  // Index of the current archetype
+    std::size_t _chunk     = 0;  // Index of the chunk within the archetype
+    std::size_t _index     = 0;  // Index of the entity within the chunk
+
+    void                                                       _skip_to_match();
+    template <typename RequestedComponent> RequestedComponent* _get_component() const;
+};
+
+template <typename... RegisteredComponents>
+class archetype_engine {
+   private:
+    class entities;
+    class components;
+    class systems;
+
+    // Type-erased operations on a component type, used to move entities between archetypes
+    struct column_type {
+        std::size_t size;
+        std::size_t alignment;
+        void (*move)(void* destination, void* source);
+        void (*destroy)(void* component);
+    };
+
+    // All entities with the same set of components, stored in chunks with a contiguous array per component
+    struct archetype_type {
+        std::uint64_t                                            mask;
+        std::size_t                                              capacity;    // Entities per chunk
+        std::size_t                                              chunk_size;  // Bytes per chunk
+        std::size_t                                              alignment;   // Alignment of the chunks
+        std::array<std::size_t, sizeof...(RegisteredComponents)> offsets;     // Byte offset of each component array in a chunk
+        std::vector<std::byte*>                                  chunks;
+        std::size_t                                              count;
+    };
+
+    struct location_type {
+        std::size_t archetype;
+        std::size_t row;
+    };
+
+   public:
+    static constexpr std::size_t chunk_size = NEAT_ECS_CHUNK_SIZE;
+
+    archetype_engine();
+    ~archetype_engine();
+    archetype_engine(const archetype_engine&)            = delete;
+    archetype_engine& operator=(const archetype_engine&) = delete;
+
+    template <typename... RequestedComponents> archetype_view<archetype_engine, true, RequestedComponents...>  iterate();
+    template <typename... RequestedComponents> archetype_view<archetype_engine, false, RequestedComponents...> iterate_components();
+
+    std::size_t archetype_count() const;
+
+    entities   entities;
+    components components;
+    systems    systems;
+
+   private:
+    template <typename, bool, typename...> friend class archetype_view;
+
+    static constexpr std::array<column_type, sizeof...(RegisteredComponents)> _columns = {
+        column_type {sizeof(RegisteredComponents), alignof(RegisteredComponents),
+                     [](void* destination, void* source) { new (destination) RegisteredComponents(std::move(*static_cast<RegisteredComponents*>(source))); },
+                     [](void* component) { static_cast<RegisteredComponents*>(component)->~RegisteredComponents(); }}...};
+
+    std::vector<archetype_type>                    _archetypes;
+    std::unordered_map<std::uint64_t, std::size_t> _archetype_indices;
+    std::vector<location_type>                     _locations;
+
+    template <typename RequestedComponent> static constexpr std::size_t   _index_of();
+    template <typename RequestedComponent> static constexpr std::uint64_t _mask_of();
+    template <typename RequestedComponent> RequestedComponent*            _get_component(entity_id entity);
+
+    std::size_t _get_archetype(std::uint64_t mask);
+    std::size_t _insert_row(std::size_t archetype, entity_id entity);
+    void        _remove_row(std::size_t archetype, std::size_t row);
+    void        _move_entity(entity_id entity, std::size_t target);
+    void*       _column_at(const archetype_type& archetype, std::size_t column, std::size_t row) const;
+    entity_id&  _entity_at(const archetype_type& archetype, std::size_t row) const;
+
+   private:
+    class entities final {
+       private:
+        friend class archetype_engine;
+        archetype_engine&     _ecs;
+        bitset                _entities;
+        std::queue<entity_id> _free_entities;
+        explicit entities(archetype_engine& e);
+
+       public:
+        entity_id              create();
+        bool                   remove(entity_id entity);
+        bool                   exists(entity_id entity) const;
+        entity_id              last() const;
+        std::vector<entity_id> all() const;
+    };
+
+    class components final {
+       private:
+        friend class archetype_engine;
+        archetype_engine& _ecs;
+        explicit components(archetype_engine& e);
+
+       public:
+        template <typename RequestedComponent> RequestedComponent*                   get(entity_id entity);
+        template <typename RequestedComponent> std::vector<RequestedComponent*>      get(const std::vector<entity_id>& entity_list);
+        template <typename RequestedComponent, typename... Args> RequestedComponent* add(entity_id entity, Args&&... args);
+
+        template <typename RequestedComponent> bool has(entity_id entity) const;
+        template <typename RequestedComponent> bool remove(entity_id entity);
+
+        template <typename RequestedComponent> std::tuple<entity_id, RequestedComponent*> first();
+    };
+
+    class systems final {
+       private:
+        friend class archetype_engine;
+        archetype_engine& _ecs;
+        explicit systems(archetype_engine& e);
+
+       public:
+        template <typename... FuncComponents> void execute(void (&system)(FuncComponents*...));
+        template <typename... FuncComponents> void execute(void (&system)(entity_id, FuncComponents*...));
+        template <typename... FuncComponents> void execute(void (&system)(archetype_engine<RegisteredComponents...>&, FuncComponents*...));
+        template <typename... FuncComponents> void execute(void (&system)(archetype_engine<RegisteredComponents...>&, entity_id, FuncComponents*...));
+    };
+};
+};  // namespace neat::ecs
+
+#pragma region bitset implementations
+
+inline neat::ecs::bitset::bitset(std::pmr::memory_resource* resource)
+    : _words(resource), _summary(resource) {}
+
+inline neat::ecs::bitset::~bitset() {}
+
+inline bool neat::ecs::bitset::test(std::size_t index) const {
+    return (_words[index / word_bits] >> (index % word_bits)) & 1;
+}
+
+inline void neat::ecs::bitset::set(std::size_t index) {
+    std::size_t word = index / word_bits;
+    _words[word] |= std::uint64_t(1) << (index % word_bits);
+    _summary[word / word_bits] |= std::uint64_t(1) << (word % word_bits);
+}
+
+inline void neat::ecs::bitset::reset(std::size_t index) {
+    std::size_t word = index / word_bits;
+    _words[word] &= ~(std::uint64_t(1) << (index % word_bits));
+    if (_words[word] == 0)
+        _summary[word / word_bits] &= ~(std::uint64_t(1) << (word % word_bits));
+}
+
+inline void neat::ecs::bitset::resize(std::size_t new_size) {
+    // Clear the bits past the new size, so that the unused bits of the last word are always zero
+    for (std::size_t index = new_size; index < _size && index % word_bits != 0; index++) {
+        reset(index);
+    }
+    std::size_t words = (new_size + word_bits - 1) / word_bits;
+    for (std::size_t word = words; word < _words.size(); word++) {
+        _summary[word / word_bits] &= ~(std::uint64_t(1) << (word % word_bits));
+    }
+    _words.resize(words, 0);
+    _summary.resize((words + word_bits - 1) / word_bits, 0);
+    _size = new_size;
+}
+
+inline void neat::ecs::bitset::assign(const void* words, std::size_t size) {
+    resize(0);
+    resize(size);
+    if (size == 0)
+        return;
+    std::memcpy(_words.data(), words, _words.size() * sizeof(std::uint64_t));
+    if (size % word_bits != 0)
+        _words.back() &= (std::uint64_t(1) << (size % word_bits)) - 1;
+    for (std::size_t word = 0; word < _words.size(); word++) {
+        if (_words[word] != 0)
+            _summary[word / word_bits] |= std::uint64_t(1) << (word % word_bits);
+    }
+}
+
+inline void neat::ecs::bitset::push_back(bool value) {
+    resize(_size + 1);
+    if (value)
+        set(_size - 1);
+}
+
+inline std::size_t neat::ecs::bitset::size() const {
+    return _size;
+}
+
+inline std::size_t neat::ecs::bitset::count() const {
+    std::size_t count = 0;
+    for (std::uint64_t word : _words) {
+        count += std::popcount(word);
+    }
+    return count;
+}
+
+inline std::size_t neat::ecs::bitset::find_next(std::size_t from) const {
+    if (from >= _size)
+        return _size;
+    std::size_t   index = from / word_bits;
+    std::uint64_t word  = _words[index] & (~std::uint64_t(0) << (from % word_bits));
+    if (word != 0)
+        return index * word_bits + std::countr_zero(word);
+
+    // Use the summary to jump to the next word which is not zero, skipping 64 empty words at a time
+    index++;
+    while (index < _words.size()) {
+        std::uint64_t summary = _summary[index / word_bits] & (~std::uint64_t(0) << (index % word_bits));
+        if (summary != 0) {
+            index = (index / word_bits) * word_bits + std::countr_zero(summary);
+            return index * word_bits + std::countr_zero(_words[index]);
+        }
+        index = (index / word_bits + 1) * word_bits;
+    }
+    return _size;
+}
+
+inline std::size_t neat::ecs::bitset::find_last() const {
+    for (std::size_t index = _words.size(); index > 0; index--) {
+        if (_words[index - 1] != 0)
+            return (index - 1) * word_bits + (word_bits - 1 - std::countl_zero(_words[index - 1]));
+    }
+    return _size;
+}
+
+inline const std::uint64_t* neat::ecs::bitset::words() const {
+    return _words.data();
+}
+
+inline std::size_t neat::ecs::bitset::word_count() const {
+    return _words.size();
+}
+
+inline std::size_t neat::ecs::bitset::reserved_bytes() const {
+    return (_words.capacity() + _summary.capacity()) * sizeof(std::uint64_t);
+}
+
+inline void neat::ecs::bitset::shrink_to_fit() {
+    _words.shrink_to_fit();
+    _summary.shrink_to_fit();
+}
+
+template <std::size_t Count>
+std::size_t neat::ecs::bitset::find_next_common(const std::array<const bitset*, Count>& sets, std::size_t from) {
+    static_assert(Count > 0, "At least one bitset is required.");
+    std::size_t size = sets[0]->_size;
+    for (const bitset* set : sets) {
+        size = std::min(size, set->_size);
+    }
+    if (from >= size)
+        return size;
+
+    std::size_t   words = (size + word_bits - 1) / word_bits;
+    std::size_t   index = from / word_bits;
+    std::uint64_t mask  = ~std::uint64_t(0) << (from % word_bits);
+
+    while (index < words) {
+        // Skip to the next word which is not zero in every set, using the summaries to skip 64 words at a time
+        std::uint64_t summary = ~std::uint64_t(0) << (index % word_bits);
+        for (const bitset* set : sets) {
+            summary &= set->_summary[index / word_bits];
+        }
+        if (summary == 0) {
+            index = (index / word_bits + 1) * word_bits;
+            mask  = ~std::uint64_t(0);
+            continue;
+        }
+        std::size_t next = (index / word_bits) * word_bits + std::countr_zero(summary);
+        if (next != index) {
+            index = next;
+            mask  = ~std::uint64_t(0);
+        }
+#if defined(__AVX2__)
+        // Skip blocks of four words which have no bits in common
+        if constexpr (Count > 1) {
+            while (mask == ~std::uint64_t(0) && index + 4 <= words) {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sets[0]->_words.data() + index));
+                for (std::size_t set = 1; set < Count; set++) {
+                    block = _mm256_and_si256(block, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sets[set]->_words.data() + index)));
+                }
+                if (!_mm256_testz_si256(block, block))
+                    break;
+                index += 4;
+            }
+            if (index == words)
+                break;
+        }
+#endif  // __AVX2__
+        std::uint64_t word = mask;
+        for (const bitset* set : sets) {
+            word &= set->_words[index];
+        }
+        if (word != 0) {
+            std::size_t found = index * word_bits + std::countr_zero(word);
+            return found < size ? found : size;
+        }
+        mask = ~std::uint64_t(0);
+        index++;
+    }
+    return size;
+}
+
+#pragma endregion bitset implementations
+
+#pragma region entity set implementations
+
+inline neat::ecs::entity_set::entity_set() {}
+
+inline neat::ecs::entity_set::~entity_set() {}
+
+inline bool neat::ecs::entity_set::contains(entity_id entity) const {
+    if (entity >= _positions.size())
+        return false;
+    return _positions[entity] != absent;
+}
+
+inline bool neat::ecs::entity_set::insert(entity_id entity) {
+    if (contains(entity))
+        return false;
+    if (entity >= _positions.size())
+        _positions.resize(entity + 1, absent);
+    _positions[entity] = _entities.size();
+    _entities.push_back(entity);
+    return true;
+}
+
+inline bool neat::ecs::entity_set::erase(entity_id entity) {
+    if (!contains(entity))
+        return false;
+    std::size_t position = _positions[entity];
+    entity_id   moved    = _entities.back();
+    _entities[position]  = moved;
+    _positions[moved]    = position;
+    _positions[entity]   = absent;
+    _entities.pop_back();
+    return true;
+}
+
+inline void neat::ecs::entity_set::clear() {
+    _positions.clear();
+    _entities.clear();
+}
+
+inline std::size_t neat::ecs::entity_set::size() const {
+    return _entities.size();
+}
+
+inline std::span<const neat::ecs::entity_id> neat::ecs::entity_set::entities() const {
+    return _entities;
+}
+
+#pragma endregion entity set implementations
+
+#pragma region snapshot implementations
+
+inline neat::ecs::snapshot_writer::snapshot_writer(std::ostream& out)
+    : _out(out) {}
+
+template <typename Value>
+void neat::ecs::snapshot_writer::value(const Value& value) {
+    static_assert(std::is_trivially_copyable_v<Value>, "Snapshot values must be trivially copyable.");
+    write(&value, sizeof(Value));
+}
+
+template <typename Function>
+void neat::ecs::snapshot_writer::blob(Function&& function) {
+    std::ostringstream stream(std::ios::binary);
+    function(static_cast<std::ostream&>(stream));
+    std::string bytes = std::move(stream).str();
+    array(bytes.data(), bytes.size());
+}
+
+template <typename ComponentType, typename Function>
+void neat::ecs::snapshot_writer::components(std::size_t count, Function&& component) {
+    if constexpr (typing::raw_snapshot<ComponentType>) {
+        value<std::uint64_t>(count * sizeof(ComponentType));
+        align();
+        for (std::size_t index = 0; index < count; index++) {
+            const ComponentType& value = component(index);
+            write(&value, sizeof(ComponentType));
+        }
+        align();
+    } else {
+        blob([count, &component](std::ostream& stream) {
+            for (std::size_t index = 0; index < count; index++) {
+                component_traits<ComponentType>::save(stream, component(index));
+            }
+        });
+    }
+}
+
+inline void neat::ecs::snapshot_writer::write(const void* data, std::size_t size) {
+    if (size == 0)
+        return;
+    _out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    _offset += size;
+}
+
+inline void neat::ecs::snapshot_writer::zeros(std::size_t size) {
+    static constexpr char zero[256] = {};
+    for (; size > sizeof(zero); size -= sizeof(zero)) {
+        write(zero, sizeof(zero));
+    }
+    write(zero, size);
+}
+
+inline void neat::ecs::snapshot_writer::align() {
+    zeros((alignment - _offset % alignment) % alignment);
+}
+
+inline void neat::ecs::snapshot_writer::array(const void* data, std::size_t size) {
+    value<std::uint64_t>(size);
+    align();
+    write(data, size);
+    align();
+}
+
+inline void neat::ecs::snapshot_writer::bits(const bitset& set, std::size_t size) {
+    value<std::uint64_t>(size);
+    array(set.words(), (size + bitset::word_bits - 1) / bitset::word_bits * sizeof(std::uint64_t));
+}
+
+inline bool neat::ecs::snapshot_writer::good() const {
+    return _out.good();
+}
+
+inline neat::ecs::snapshot_reader::blob_buffer::blob_buffer(std::span<const std::byte> bytes) {
+    // The get area is never written to, std::streambuf only lacks a constant variant
+    char* begin = const_cast<char*>(reinterpret_cast<const char*>(bytes.data()));
+    setg(begin, begin, begin + bytes.size());
+}
+
+inline neat::ecs::snapshot_reader::snapshot_reader(std::span<const std::byte> data)
+    : _data(data) {}
+
+template <typename Value>
+Value neat::ecs::snapshot_reader::value() {
+    static_assert(std::is_trivially_copyable_v<Value>, "Snapshot values must be trivially copyable.");
+    Value                      result {};
+    std::span<const std::byte> bytes = read(sizeof(Value));
+    if (!_failed)
+        std::memcpy(&result, bytes.data(), sizeof(Value));
+    return result;
+}
+
+template <typename Value>
+std::vector<Value> neat::ecs::snapshot_reader::values() {
+    static_assert(std::is_trivially_copyable_v<Value>, "Snapshot values must be trivially copyable.");
+    std::span<const std::byte> bytes = array();
+    if (_failed || bytes.size() % sizeof(Value) != 0) {
+        _failed = true;
+        return {};
+    }
+    std::vector<Value> result(bytes.size() / sizeof(Value));
+    if (!result.empty())
+        std::memcpy(result.data(), bytes.data(), bytes.size());
+    return result;
+}
+
+template <typename ComponentType, typename Function>
+bool neat::ecs::snapshot_reader::components(std::size_t count, Function&& function) {
+    if constexpr (typing::raw_snapshot<ComponentType>) {
+        std::span<const std::byte> bytes = array();
+        if (_failed || bytes.size() != count * sizeof(ComponentType)) {
+            _failed = true;
+            return false;
+        }
+        if constexpr (std::is_default_constructible_v<ComponentType>) {
+            // Copy all components at once, when they can be created before they are overwritten
+            std::vector<ComponentType> components(count);
+            if (count > 0)
+                std::memcpy(static_cast<void*>(components.data()), bytes.data(), bytes.size());
+            for (std::size_t index = 0; index < count; index++) {
+                function(index, std::move(components[index]));
+            }
+        } else {
+            for (std::size_t index = 0; index < count; index++) {
+                std::array<std::byte, sizeof(ComponentType)> component;
+                std::memcpy(component.data(), bytes.data() + index * sizeof(ComponentType), sizeof(ComponentType));
+                function(index, std::bit_cast<ComponentType>(component));
+            }
+        }
+        return true;
+    } else {
+        return blob([count, &function](std::istream& stream) {
+            for (std::size_t index = 0; index < count && stream; index++) {
+                function(index, component_traits<ComponentType>::load(stream));
+            }
+        });
+    }
+}
+
+template <typename Function>
+bool neat::ecs::snapshot_reader::blob(Function&& function) {
+    std::span<const std::byte> bytes = array();
+    if (_failed)
+        return false;
+    blob_buffer  buffer(bytes);
+    std::istream stream(&buffer);
+    function(stream);
+    _failed = _failed || stream.fail();
+    return !_failed;
+}
+
+inline std::span<const std::byte> neat::ecs::snapshot_reader::read(std::size_t size) {
+    if (_failed || size > _data.size() - _offset) {
+        _failed = true;
+        return {};
+    }
+    std::span<const std::byte> bytes = _data.subspan(_offset, size);
+    _offset += size;
+    return bytes;
+}
+
+inline void neat::ecs::snapshot_reader::align() {
+    read((snapshot_writer::alignment - _offset % snapshot_writer::alignment) % snapshot_writer::alignment);
+}
+
+inline std::span<const std::byte> neat::ecs::snapshot_reader::array() {
+    std::uint64_t size = value<std::uint64_t>();
+    align();
+    std::span<const std::byte> bytes = read(size);
+    align();
+    return bytes;
+}
+
+inline bool neat::ecs::snapshot_reader::bits(bitset& set) {
+    std::uint64_t              size  = value<std::uint64_t>();
+    std::span<const std::byte> words = array();
+    if (_failed || words.size() != (size + bitset::word_bits - 1) / bitset::word_bits * sizeof(std::uint64_t) || size / bitset::word_bits > words.size()) {
+        _failed = true;
+        return false;
+    }
+    set.assign(words.data(), size);
+    return true;
+}
+
+inline bool neat::ecs::snapshot_reader::failed() const {
+    return _failed;
+}
+
+#pragma endregion snapshot implementations
+
+#pragma region profiler implementations
+
+inline neat::ecs::profiler::scope::scope(profiler& profiler, const system_id& system, bool run)
+    : _profiler(&profiler), _system(system), _run(run), _start(clock::now()) {}
+
+inline neat::ecs::profiler::scope::~scope() {
+    _profiler->_record(_system, _run, _start, _query, _entities);
+}
+
+template <typename Function>
+decltype(auto) neat::ecs::profiler::scope::query(Function&& function) {
+    clock::time_point start = clock::now();
+    if constexpr (std::is_void_v<std::invoke_result_t<Function>>) {
+        function();
+        _query += clock::now() - start;
+    } else {
+        decltype(auto) result = function();
+        _query += clock::now() - start;
+        return result;
+    }
+}
+
+inline void neat::ecs::profiler::scope::visit(std::size_t entities) {
+    _entities += entities;
+}
+
+inline neat::ecs::profiler::profiler()
+    : _epoch(clock::now()) {}
+
+template <typename System>
+neat::ecs::profiler::system_id neat::ecs::profiler::identify(const System& system) {
+    if constexpr (std::is_function_v<System>)
+        return {reinterpret_cast<std::uintptr_t>(&system), {}};
+    else
+        return {reinterpret_cast<std::uintptr_t>(&typeid(System)), typing::type_name<System>()};
+}
+
+inline void neat::ecs::profiler::name(const system_id& system, std::string name) {
+    std::lock_guard lock(_mutex);
+    _systems[_index_of(system)].name = std::move(name);
+}
+
+inline std::vector<neat::ecs::system_profile> neat::ecs::profiler::systems() const {
+    std::lock_guard lock(_mutex);
+    return _systems;
+}
+
+inline void neat::ecs::profiler::reset() {
+    // Names are kept, so that systems keep their names over resets
+    std::lock_guard lock(_mutex);
+    for (system_profile& system : _systems) {
+        system = {std::move(system.name)};
+    }
+    _events.clear();
+    _epoch = clock::now();
+}
+
+inline void neat::ecs::profiler::write_trace(std::ostream& out, const std::vector<component_profile>& components) const {
+    auto escaped = [](std::string_view text) {
+        std::string result;
+        for (char character : text) {
+            if (character == '"' || character == '\\')
+                result += '\\';
+            result += character;
+        }
+        return result;
+    };
+    auto microseconds = [](clock::duration duration) { return std::chrono::duration<double, std::micro>(duration).count(); };
+
+    std::lock_guard lock(_mutex);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    const char* separator = "";
+    for (const event& record : _events) {
+        out << separator << "{\"name\":\"" << escaped(_systems[record.system].name) << "\",\"cat\":\"system\",\"ph\":\"X\",\"pid\":0,\"tid\":" << record.thread
+            << ",\"ts\":" << microseconds(record.start - _epoch) << ",\"dur\":" << microseconds(record.duration) << "}";
+        separator = ",";
+    }
+    double now = microseconds(clock::now() - _epoch);
+    for (const component_profile& component : components) {
+        out << separator << "{\"name\":\"" << escaped(component.name) << "\",\"cat\":\"component\",\"ph\":\"C\",\"pid\":0,\"ts\":" << now
+            << ",\"args\":{\"count\":" << component.count << ",\"reserved_bytes\":" << component.counters.reserved_bytes << "}}";
+        separator = ",";
+    }
+    out << "]}";
+}
+
+inline std::size_t neat::ecs::profiler::_index_of(const system_id& system) {
+    auto [found, inserted] = _indices.try_emplace(system.key, _systems.size());
+    if (inserted) {
+        std::ostringstream address;
+        address << "system " << std::hex << "0x" << system.key;
+        _systems.push_back({system.type.empty() ? address.str() : std::string(system.type)});
+    }
+    return found->second;
+}
+
+inline void neat::ecs::profiler::_record(const system_id& system, bool run, clock::time_point start, clock::duration query, std::size_t entities) {
+    clock::time_point end = clock::now();
+    std::lock_guard   lock(_mutex);
+    std::size_t       index   = _index_of(system);
+    system_profile&   profile = _systems[index];
+    if (run) {
+        profile.runs++;
+        profile.total_ns += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    profile.entities += entities;
+    profile.query_ns += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(query).count());
+    std::size_t thread = _threads.try_emplace(std::this_thread::get_id(), _threads.size()).first->second;
+    _events.push_back({index, start, end - start, thread});
+}
+
+#pragma endregion profiler implementations
+
+#pragma region thread pool implementations
+
+inline neat::ecs::thread_pool::thread_pool(std::size_t thread_count) {
+    // The thread calling parallel_for also executes tasks, so one less worker thread is needed
+    std::size_t workers = thread_count > 1 ? thread_count - 1 : 0;
+    _queue_count        = std::max<std::size_t>(workers, 1);
+    _queues             = std::make_unique<queue[]>(_queue_count);
+    _threads.reserve(workers);
+    for (std::size_t index = 0; index < workers; index++) {
+        _threads.emplace_back(&thread_pool::_work, this, index);
+    }
+}
+
+inline neat::ecs::thread_pool::~thread_pool() {
+    {
+        std::lock_guard lock(_mutex);
+        _stopping = true;
+    }
+    _condition.notify_all();
+    for (std::thread& thread : _threads) {
+        thread.join();
+    }
+}
+
+inline std::size_t neat::ecs::thread_pool::thread_count() const {
+    return _threads.size() + 1;
+}
+
+inline std::size_t neat::ecs::thread_pool::thread_index() const {
+    // Worker threads are numbered from one, threads outside of the pool use zero
+    return _current_pool == this ? _current_queue + 1 : 0;
+}
+
+inline void neat::ecs::thread_pool::parallel_for(std::size_t begin, std::size_t end, std::size_t grain_size, const std::function<void(std::size_t, std::size_t)>& function) {
+    if (begin >= end)
+        return;
+    grain_size = std::max<std::size_t>(grain_size, 1);
+
+    std::size_t chunks = (end - begin + grain_size - 1) / grain_size;
+    job         current {function, chunks, nullptr, {}};
+
+    // Spread the chunks over the queues, idle threads will steal from the others
+    std::size_t preferred = _current_pool == this ? _current_queue : 0;
+    for (std::size_t chunk = 0; chunk < chunks; chunk++) {
+        std::size_t     first  = begin + chunk * grain_size;
+        queue&          target = _queues[(preferred + chunk) % _queue_count];
+        std::lock_guard lock(target.mutex);
+        target.tasks.push_back({&current, first, std::min(first + grain_size, end)});
+    }
+    {
+        std::lock_guard lock(_mutex);
+        _pending += chunks;
+    }
+    _condition.notify_all();
+
+    // Help with executing tasks until all chunks of this job are done
+    while (current.remaining.load() != 0) {
+        if (_run_one(preferred))
+            continue;
+        std::unique_lock lock(_mutex);
+        _condition.wait(lock, [this, &current] { return current.remaining.load() == 0 || _pending.load() > 0; });
+    }
+
+    if (current.error)
+        std::rethrow_exception(current.error);
+}
+
+inline void neat::ecs::thread_pool::_work(std::size_t index) {
+    _current_pool  = this;
+    _current_queue = index;
+    while (true) {
+        if (_run_one(index))
+            continue;
+        std::unique_lock lock(_mutex);
+        _condition.wait(lock, [this] { return _stopping || _pending.load() > 0; });
+        if (_stopping && _pending.load() == 0)
+            return;
+    }
+}
+
+inline bool neat::ecs::thread_pool::_run_one(std::size_t preferred) {
+    task next {nullptr, 0, 0};
+
+    // Take the most recent task of the own queue, or steal the oldest task of another queue
+    for (std::size_t offset = 0; offset < _queue_count && next.owner == nullptr; offset++) {
+        queue&          source = _queues[(preferred + offset) % _queue_count];
+        std::lock_guard lock(source.mutex);
+        if (source.tasks.empty())
+            continue;
+        if (offset == 0) {
+            next = source.tasks.back();
+            source.tasks.pop_back();
+        } else {
+            next = source.tasks.front();
+            source.tasks.pop_front();
+        }
+    }
+    if (next.owner == nullptr)
+        return false;
+    _pending--;
+
+    try {
+        next.owner->function(next.begin, next.end);
+    } catch (...) {
+        std::lock_guard lock(next.owner->error_mutex);
+        if (!next.owner->error)
+            next.owner->error = std::current_exception();
+    }
+
+    // The job can be destroyed as soon as the last task is done, so it may not be touched afterwards
+    if (next.owner->remaining.fetch_sub(1) == 1) {
+        std::lock_guard lock(_mutex);
+        _condition.notify_all();
+    }
+    return true;
+}
+
+#pragma endregion thread pool implementations
+
+#pragma region componentlist implementations
+
+template <typename ComponentType>
+neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist(std::pmr::memory_resource* resource)
+    : _tags(resource), _allocator(resource), _added_ticks(resource), _changed_ticks(resource) {
+    static_assert(std::is_class_v<ComponentType>, "Component type is not a struct or class.");
+    static_assert(std::is_move_constructible_v<ComponentType>, "Component type does not have a move constructor.");
+}
+
+template <typename ComponentType>
+neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::~componentlist() {
+    if constexpr (!std::is_trivially_destructible_v<ComponentType>) {
+        for (entity_id entity = _tags.find_next(0); entity < _tags.size(); entity = _tags.find_next(entity + 1)) {
+            std::destroy_at(_components + entity);
+        }
+    }
+    if (_components != nullptr)
+        allocator_traits::deallocate(_allocator, _components, _capacity);
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::has(
+    entity_id entity) const {
+    if (entity >= _tags.size())
+        return false;
+    return _tags.test(entity);
+}
+
+template <typename ComponentType>
+ComponentType* neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::get(entity_id entity) {
+    if (!has(entity))
+        return nullptr;
+    return &_components[entity];
+}
+
+template <typename ComponentType>
+template <typename... Args>
+ComponentType* neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::add(neat::ecs::entity_id entity, Args&&... args) {
+    static_assert(std::is_constructible_v<ComponentType, Args...>, "Component type can't be built from given arguments.");
+    // The arguments may refer to the existing component, or to components which are relocated when growing
+    if (has(entity)) {
+        ComponentType component(std::forward<Args>(args)...);
+        remove(entity);
+        return _construct(entity, std::move(component));
+    }
+    if (entity >= _capacity) {
+        ComponentType component(std::forward<Args>(args)...);
+        _reserve(std::max(entity + 1, _capacity * 2));
+        return _construct(entity, std::move(component));
+    }
+    return _construct(entity, std::forward<Args>(args)...);
+}
+
+template <typename ComponentType>
+template <typename... Args>
+ComponentType* neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::_construct(entity_id entity, Args&&... args) {
+    if (entity >= _tags.size())
+        _tags.resize(entity + 1);
+    ComponentType* component = std::construct_at(_components + entity, std::forward<Args>(args)...);
+    _tags.set(entity);
+    _count++;
+    if constexpr (profiling)
+        _counters.adds++;
+    return component;
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::remove(entity_id entity) {
+    if (!has(entity))
+        return false;
+    _tags.reset(entity);
+    _count--;
+    std::destroy_at(_components + entity);
+    if constexpr (profiling)
+        _counters.removes++;
+    return true;
+}
+
+template <typename ComponentType>
+std::tuple<neat::ecs::entity_id, ComponentType*> neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::first() {
+    entity_id entity = _tags.find_next(0);
+    if (entity >= _tags.size())
+        return {invalid_entity, nullptr};
+    return {entity, &_components[entity]};
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::allocate(
+    size_t new_count) {
+    if (new_count < _tags.size()) {
+        return false;
+    }
+    _reserve(new_count);
+    _tags.resize(new_count);
+    return true;
+}
+
+template <typename ComponentType>
+std::size_t neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::size() const {
+    return _count;
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::_reserve(std::size_t new_capacity) {
+    if (new_capacity <= _capacity)
+        return;
+    _reallocate(new_capacity);
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::_reallocate(std::size_t new_capacity) {
+    // Relocate the existing components into the new storage, which must fit every entity id of the tags
+    ComponentType* components = new_capacity > 0 ? allocator_traits::allocate(_allocator, new_capacity) : nullptr;
+    if (_components != nullptr) {
+        if constexpr (std::is_trivially_copyable_v<ComponentType>) {
+            if (components != nullptr)
+                std::memcpy(static_cast<void*>(components), static_cast<const void*>(_components), std::min(_tags.size(), new_capacity) * sizeof(ComponentType));
+        } else {
+            for (entity_id entity = _tags.find_next(0); entity < _tags.size(); entity = _tags.find_next(entity + 1)) {
+                std::construct_at(components + entity, std::move_if_noexcept(_components[entity]));
+                std::destroy_at(_components + entity);
+            }
+        }
+        allocator_traits::deallocate(_allocator, _components, _capacity);
+    }
+    _components = components;
+    _capacity   = new_capacity;
+    if constexpr (profiling)
+        _counters.resizes++;
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::shrink_to_fit() {
+    std::size_t last  = _tags.find_last();
+    std::size_t count = last < _tags.size() ? last + 1 : 0;
+    _tags.resize(count);
+    _tags.shrink_to_fit();
+    if (count < _capacity)
+        _reallocate(count);
+    _added_ticks.resize(std::min(_added_ticks.size(), count));
+    _added_ticks.shrink_to_fit();
+    _changed_ticks.resize(std::min(_changed_ticks.size(), count));
+    _changed_ticks.shrink_to_fit();
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::compact(std::span<const entity_id> remap, std::size_t count) {
+    for (entity_id entity = _tags.find_next(0); entity < _tags.size(); entity = _tags.find_next(entity + 1)) {
+        entity_id target = remap[entity];
+        if (target == entity)
+            continue;
+        std::construct_at(_components + target, std::move(_components[entity]));
+        std::destroy_at(_components + entity);
+        _tags.reset(entity);
+        _tags.set(target);
+        if constexpr (typing::tracks_changes<ComponentType>) {
+            _added_ticks[target]   = _added_ticks[entity];
+            _changed_ticks[target] = _changed_ticks[entity];
+        }
+    }
+    _tags.resize(std::min(_tags.size(), count));
+    _reallocate(_tags.size());
+    _added_ticks.resize(std::min(_added_ticks.size(), count));
+    _added_ticks.shrink_to_fit();
+    _changed_ticks.resize(std::min(_changed_ticks.size(), count));
+    _changed_ticks.shrink_to_fit();
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::clear() {
+    if constexpr (!std::is_trivially_destructible_v<ComponentType>) {
+        for (entity_id entity = _tags.find_next(0); entity < _tags.size(); entity = _tags.find_next(entity + 1)) {
+            std::destroy_at(_components + entity);
+        }
+    }
+    std::size_t size = _tags.size();
+    _tags.resize(0);
+    _tags.resize(size);
+    _count = 0;
+    _added_ticks.clear();
+    _changed_ticks.clear();
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::save(snapshot_writer& out) const {
+    static_assert(typing::raw_snapshot<ComponentType> || typing::custom_snapshot<ComponentType>, "Component type is not trivially copyable and has no save and load functions in its traits.");
+    std::size_t last   = _tags.find_last();
+    std::size_t extent = last < _tags.size() ? last + 1 : 0;
+    out.bits(_tags, extent);
+
+    if constexpr (typing::raw_snapshot<ComponentType>) {
+        // The whole array is written at once, slots without a component are written as zeros
+        out.value<std::uint64_t>(extent * sizeof(ComponentType));
+        out.align();
+        for (entity_id entity = 0; entity < extent;) {
+            entity_id run = entity;
+            while (run < extent && _tags.test(run)) {
+                run++;
+            }
+            out.write(_components + entity, (run - entity) * sizeof(ComponentType));
+            for (entity = run; entity < extent && !_tags.test(entity); entity++) {}
+            out.zeros((entity - run) * sizeof(ComponentType));
+        }
+        out.align();
+    } else {
+        out.blob([this, extent](std::ostream& stream) {
+            for (entity_id entity = _tags.find_next(0); entity < extent; entity = _tags.find_next(entity + 1)) {
+                component_traits<ComponentType>::save(stream, _components[entity]);
+            }
+        });
+    }
+
+    if constexpr (typing::tracks_changes<ComponentType>) {
+        std::size_t ticks = std::min(_added_ticks.size(), extent);
+        out.array(_added_ticks.data(), ticks * sizeof(tick_type));
+        out.array(_changed_ticks.data(), ticks * sizeof(tick_type));
+    }
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::restore(snapshot_reader& in, std::size_t capacity) {
+    clear();
+    bitset tags(_allocator.resource());
+    if (!in.bits(tags) || tags.size() > capacity)
+        return false;
+    std::size_t extent = tags.size();
+    _reserve(extent);
+    _tags.resize(std::max(_tags.size(), extent));
+
+    if constexpr (typing::raw_snapshot<ComponentType>) {
+        std::span<const std::byte> components = in.array();
+        if (in.failed() || components.size() != extent * sizeof(ComponentType))
+            return false;
+        if (extent > 0)
+            std::memcpy(static_cast<void*>(_components), components.data(), components.size());
+        _tags.assign(tags.words(), extent);
+        _tags.resize(std::max(_tags.size(), extent));
+        _count = tags.count();
+    } else {
+        bool loaded = in.blob([this, &tags, extent](std::istream& stream) {
+            for (entity_id entity = tags.find_next(0); entity < extent && stream; entity = tags.find_next(entity + 1)) {
+                std::construct_at(_components + entity, component_traits<ComponentType>::load(stream));
+                _tags.set(entity);
+                _count++;
+            }
+        });
+        if (!loaded)
+            return false;
+    }
+
+    if constexpr (typing::tracks_changes<ComponentType>) {
+        std::span<const std::byte> added   = in.array();
+        std::span<const std::byte> changed = in.array();
+        if (in.failed() || added.size() != changed.size() || added.size() > extent * sizeof(tick_type) || added.size() % sizeof(tick_type) != 0)
+            return false;
+        if (!added.empty()) {
+            _added_ticks.resize(_tags.size(), 0);
+            _changed_ticks.resize(_tags.size(), 0);
+            std::memcpy(_added_ticks.data(), added.data(), added.size());
+            std::memcpy(_changed_ticks.data(), changed.data(), changed.size());
+        }
+    }
+    return true;
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::diff(const componentlist& base, const bitset& alive, snapshot_writer& out) const {
+    static_assert(typing::raw_snapshot<ComponentType> || typing::custom_snapshot<ComponentType>, "Component type is not trivially copyable and has no save and load functions in its traits.");
+    std::vector<entity_id> removed;
+    for (entity_id entity = base._tags.find_next(0); entity < base._tags.size(); entity = base._tags.find_next(entity + 1)) {
+        if (!has(entity) && entity < alive.size() && alive.test(entity))
+            removed.push_back(entity);
+    }
+    std::vector<entity_id> changed;
+    for (entity_id entity = _tags.find_next(0); entity < _tags.size(); entity = _tags.find_next(entity + 1)) {
+        bool same = base.has(entity) && typing::same_snapshot(_components[entity], base._components[entity]);
+        if constexpr (typing::tracks_changes<ComponentType>)
+            same = same && _added_ticks[entity] == base._added_ticks[entity] && _changed_ticks[entity] == base._changed_ticks[entity];
+        if (!same)
+            changed.push_back(entity);
+    }
+
+    out.array(removed.data(), removed.size() * sizeof(entity_id));
+    out.array(changed.data(), changed.size() * sizeof(entity_id));
+    out.components<ComponentType>(changed.size(), [this, &changed](std::size_t index) -> const ComponentType& { return _components[changed[index]]; });
+    if constexpr (typing::tracks_changes<ComponentType>) {
+        std::vector<tick_type> ticks;
+        for (entity_id entity : changed) {
+            ticks.push_back(_added_ticks[entity]);
+            ticks.push_back(_changed_ticks[entity]);
+        }
+        out.array(ticks.data(), ticks.size() * sizeof(tick_type));
+    }
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::apply(snapshot_reader& in, std::size_t capacity, std::vector<entity_id>& touched) {
+    std::vector<entity_id> removed = in.values<entity_id>();
+    std::vector<entity_id> changed = in.values<entity_id>();
+    if (in.failed() || std::ranges::any_of(changed, [capacity](entity_id entity) { return entity >= capacity; }))
+        return false;
+    for (entity_id entity : removed) {
+        if (remove(entity))
+            touched.push_back(entity);
+    }
+    bool loaded = in.components<ComponentType>(changed.size(), [this, &changed](std::size_t index, ComponentType&& component) {
+        add(changed[index], std::move(component));
+    });
+    if (!loaded)
+        return false;
+    touched.insert(touched.end(), changed.begin(), changed.end());
+
+    if constexpr (typing::tracks_changes<ComponentType>) {
+        std::vector<tick_type> ticks = in.values<tick_type>();
+        if (in.failed() || ticks.size() != changed.size() * 2)
+            return false;
+        for (std::size_t index = 0; index < changed.size(); index++) {
+            set_added(changed[index], ticks[index * 2]);
+            set_changed(changed[index], ticks[index * 2 + 1]);
+        }
+    }
+    return true;
+}
+
+template <typename ComponentType>
+std::size_t neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::capacity() const {
+    return _capacity;
+}
+
+template <typename ComponentType>
+neat::ecs::list_counters neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::counters() const {
+    list_counters counters  = _counters;
+    counters.reserved_bytes = _capacity * sizeof(ComponentType) + _tags.reserved_bytes() + (_added_ticks.capacity() + _changed_ticks.capacity()) * sizeof(tick_type);
+    return counters;
+}
+
+template <typename ComponentType>
+const neat::ecs::bitset& neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::tags() const {
+    return _tags;
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::set_added(entity_id entity, tick_type tick) {
+    static_assert(typing::tracks_changes<ComponentType>, "Component type does not track changes.");
+    if (entity >= _added_ticks.size()) {
+        _added_ticks.resize(_tags.size(), 0);
+        _changed_ticks.resize(_tags.size(), 0);
+    }
+    _added_ticks[entity]   = tick;
+    _changed_ticks[entity] = tick;
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::set_changed(entity_id entity, tick_type tick) {
+    static_assert(typing::tracks_changes<ComponentType>, "Component type does not track changes.");
+    _changed_ticks[entity] = tick;
+}
+
+template <typename ComponentType>
+neat::ecs::tick_type neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::added_tick(entity_id entity) const {
+    static_assert(typing::tracks_changes<ComponentType>, "Component type does not track changes.");
+    return _added_ticks[entity];
+}
+
+template <typename ComponentType>
+neat::ecs::tick_type neat::ecs::componentlist<ComponentType, neat::ecs::dense_storage>::componentlist::changed_tick(entity_id entity) const {
+    static_assert(typing::tracks_changes<ComponentType>, "Component type does not track changes.");
+    return _changed_ticks[entity];
+}
+
+template <typename ComponentType>
+neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::componentlist(std::pmr::memory_resource* resource)
+    : _sparse(resource), _entities(resource), _components(resource), _added_ticks(resource), _changed_ticks(resource) {
+    static_assert(std::is_class_v<ComponentType>, "Component type is not a struct or class.");
+    static_assert(std::is_move_constructible_v<ComponentType>, "Component type does not have a move constructor.");
+}
+
+template <typename ComponentType>
+neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::~componentlist() {}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::has(entity_id entity) const {
+    if (entity >= _sparse.size())
+        return false;
+    return _sparse[entity] != absent;
+}
+
+template <typename ComponentType>
+ComponentType* neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::get(entity_id entity) {
+    if (!has(entity))
+        return nullptr;
+    return &_components[_sparse[entity]];
+}
+
+template <typename ComponentType>
+template <typename... Args>
+ComponentType* neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::add(entity_id entity, Args&&... args) {
+    static_assert(std::is_constructible_v<ComponentType, Args...>, "Component type can't be built from given arguments.");
+    // The arguments may refer to the existing component, or to components which are relocated when growing
+    if (has(entity)) {
+        ComponentType component(std::forward<Args>(args)...);
+        remove(entity);
+        return _push(entity, std::move(component));
+    }
+    if (_components.size() == _components.capacity()) {
+        ComponentType component(std::forward<Args>(args)...);
+        return _push(entity, std::move(component));
+    }
+    return _push(entity, std::forward<Args>(args)...);
+}
+
+template <typename ComponentType>
+template <typename... Args>
+ComponentType* neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::_push(entity_id entity, Args&&... args) {
+    if (entity >= _sparse.size())
+        _sparse.resize(entity + 1, absent);
+
+    std::size_t capacity = _components.capacity();
+    _components.emplace_back(std::forward<Args>(args)...);
+    _sparse[entity] = _entities.size();
+    _entities.push_back(entity);
+    if constexpr (typing::tracks_changes<ComponentType>) {
+        _added_ticks.push_back(0);
+        _changed_ticks.push_back(0);
+    }
+    if constexpr (profiling) {
+        _counters.adds++;
+        _counters.resizes += _components.capacity() != capacity;
+    }
+    return &_components.back();
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::remove(entity_id entity) {
+    if (!has(entity))
+        return false;
+
+    // Move the last component into the hole, keeping the packed arrays contiguous
+    std::size_t index = _sparse[entity];
+    std::size_t last  = _entities.size() - 1;
+    if (index != last) {
+        _entities[index] = _entities[last];
+        if constexpr (std::is_move_assignable_v<ComponentType>) {
+            _components[index] = std::move(_components[last]);
+        } else {
+            std::destroy_at(&_components[index]);
+            std::construct_at(&_components[index], std::move(_components[last]));
+        }
+        _sparse[_entities[index]] = index;
+        if constexpr (typing::tracks_changes<ComponentType>) {
+            _added_ticks[index]   = _added_ticks[last];
+            _changed_ticks[index] = _changed_ticks[last];
+        }
+    }
+    _entities.pop_back();
+    _components.pop_back();
+    if constexpr (typing::tracks_changes<ComponentType>) {
+        _added_ticks.pop_back();
+        _changed_ticks.pop_back();
+    }
+    _sparse[entity] = absent;
+    if constexpr (profiling)
+        _counters.removes++;
+    return true;
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::allocate(size_t new_count) {
+    if (new_count < _sparse.size()) {
+        return false;
+    }
+    // Only the index grows, the packed arrays grow with the components which are actually added
+    _sparse.resize(new_count, absent);
+    return true;
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::shrink_to_fit() {
+    std::size_t count = 0;
+    for (entity_id entity : _entities) {
+        count = std::max<std::size_t>(count, entity + 1);
+    }
+    _sparse.resize(std::min(_sparse.size(), count));
+    _sparse.shrink_to_fit();
+    _entities.shrink_to_fit();
+    _components.shrink_to_fit();
+    _added_ticks.shrink_to_fit();
+    _changed_ticks.shrink_to_fit();
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::compact(std::span<const entity_id> remap, std::size_t count) {
+    // The packed arrays keep their order, only the entity ids and the sparse indices change
+    _sparse.assign(std::min(_sparse.size(), count), absent);
+    _sparse.shrink_to_fit();
+    for (std::size_t index = 0; index < _entities.size(); index++) {
+        _entities[index]          = remap[_entities[index]];
+        _sparse[_entities[index]] = index;
+    }
+    _entities.shrink_to_fit();
+    _components.shrink_to_fit();
+    _added_ticks.shrink_to_fit();
+    _changed_ticks.shrink_to_fit();
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::clear() {
+    std::fill(_sparse.begin(), _sparse.end(), absent);
+    _entities.clear();
+    _components.clear();
+    _added_ticks.clear();
+    _changed_ticks.clear();
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::save(snapshot_writer& out) const {
+    static_assert(typing::raw_snapshot<ComponentType> || typing::custom_snapshot<ComponentType>, "Component type is not trivially copyable and has no save and load functions in its traits.");
+    out.array(_entities.data(), _entities.size() * sizeof(entity_id));
+    if constexpr (typing::raw_snapshot<ComponentType>) {
+        out.array(_components.data(), _components.size() * sizeof(ComponentType));
+    } else {
+        out.blob([this](std::ostream& stream) {
+            for (const ComponentType& component : _components) {
+                component_traits<ComponentType>::save(stream, component);
+            }
+        });
+    }
+    if constexpr (typing::tracks_changes<ComponentType>) {
+        out.array(_added_ticks.data(), _added_ticks.size() * sizeof(tick_type));
+        out.array(_changed_ticks.data(), _changed_ticks.size() * sizeof(tick_type));
+    }
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::restore(snapshot_reader& in, std::size_t capacity) {
+    clear();
+    std::span<const std::byte> entities = in.array();
+    if (in.failed() || entities.size() % sizeof(entity_id) != 0)
+        return false;
+    std::size_t count = entities.size() / sizeof(entity_id);
+    _entities.resize(count);
+    if (count > 0)
+        std::memcpy(_entities.data(), entities.data(), entities.size());
+    for (std::size_t index = 0; index < count; index++) {
+        entity_id entity = _entities[index];
+        if (entity >= capacity)
+            return false;
+        if (entity >= _sparse.size())
+            _sparse.resize(entity + 1, absent);
+        if (_sparse[entity] != absent)
+            return false;
+        _sparse[entity] = index;
+    }
+
+    if constexpr (typing::raw_snapshot<ComponentType>) {
+        std::span<const std::byte> components = in.array();
+        if (in.failed() || components.size() != count * sizeof(ComponentType))
+            return false;
+        if constexpr (std::is_default_constructible_v<ComponentType>) {
+            _components.resize(count);
+            if (count > 0)
+                std::memcpy(static_cast<void*>(_components.data()), components.data(), components.size());
+        } else {
+            _components.reserve(count);
+            for (std::size_t index = 0; index < count; index++) {
+                std::array<std::byte, sizeof(ComponentType)> bytes;
+                std::memcpy(bytes.data(), components.data() + index * sizeof(ComponentType), sizeof(ComponentType));
+                _components.push_back(std::bit_cast<ComponentType>(bytes));
+            }
+        }
+    } else {
+        bool loaded = in.blob([this, count](std::istream& stream) {
+            _components.reserve(count);
+            for (std::size_t index = 0; index < count && stream; index++) {
+                _components.push_back(component_traits<ComponentType>::load(stream));
+            }
+        });
+        if (!loaded || _components.size() != count)
+            return false;
+    }
+
+    if constexpr (typing::tracks_changes<ComponentType>) {
+        std::span<const std::byte> added   = in.array();
+        std::span<const std::byte> changed = in.array();
+        if (in.failed() || added.size() != count * sizeof(tick_type) || changed.size() != count * sizeof(tick_type))
+            return false;
+        _added_ticks.resize(count);
+        _changed_ticks.resize(count);
+        if (count > 0) {
+            std::memcpy(_added_ticks.data(), added.data(), added.size());
+            std::memcpy(_changed_ticks.data(), changed.data(), changed.size());
+        }
+    }
+    return true;
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::diff(const componentlist& base, const bitset& alive, snapshot_writer& out) const {
+    static_assert(typing::raw_snapshot<ComponentType> || typing::custom_snapshot<ComponentType>, "Component type is not trivially copyable and has no save and load functions in its traits.");
+    std::vector<entity_id> removed;
+    for (entity_id entity : base._entities) {
+        if (!has(entity) && entity < alive.size() && alive.test(entity))
+            removed.push_back(entity);
+    }
+    std::vector<std::size_t> changed;  // Indices in the packed arrays
+    for (std::size_t index = 0; index < _entities.size(); index++) {
+        entity_id entity = _entities[index];
+        bool      same   = base.has(entity) && typing::same_snapshot(_components[index], base._components[base._sparse[entity]]);
+        if constexpr (typing::tracks_changes<ComponentType>)
+            same = same && _added_ticks[index] == base._added_ticks[base._sparse[entity]] && _changed_ticks[index] == base._changed_ticks[base._sparse[entity]];
+        if (!same)
+            changed.push_back(index);
+    }
+
+    std::vector<entity_id> changed_entities;
+    for (std::size_t index : changed) {
+        changed_entities.push_back(_entities[index]);
+    }
+    out.array(removed.data(), removed.size() * sizeof(entity_id));
+    out.array(changed_entities.data(), changed_entities.size() * sizeof(entity_id));
+    out.components<ComponentType>(changed.size(), [this, &changed](std::size_t index) -> const ComponentType& { return _components[changed[index]]; });
+    if constexpr (typing::tracks_changes<ComponentType>) {
+        std::vector<tick_type> ticks;
+        for (std::size_t index : changed) {
+            ticks.push_back(_added_ticks[index]);
+            ticks.push_back(_changed_ticks[index]);
+        }
+        out.array(ticks.data(), ticks.size() * sizeof(tick_type));
+    }
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::apply(snapshot_reader& in, std::size_t capacity, std::vector<entity_id>& touched) {
+    std::vector<entity_id> removed = in.values<entity_id>();
+    std::vector<entity_id> changed = in.values<entity_id>();
+    if (in.failed() || std::ranges::any_of(changed, [capacity](entity_id entity) { return entity >= capacity; }))
+        return false;
+    for (entity_id entity : removed) {
+        if (remove(entity))
+            touched.push_back(entity);
+    }
+    bool loaded = in.components<ComponentType>(changed.size(), [this, &changed](std::size_t index, ComponentType&& component) {
+        add(changed[index], std::move(component));
+    });
+    if (!loaded)
+        return false;
+    touched.insert(touched.end(), changed.begin(), changed.end());
+
+    if constexpr (typing::tracks_changes<ComponentType>) {
+        std::vector<tick_type> ticks = in.values<tick_type>();
+        if (in.failed() || ticks.size() != changed.size() * 2)
+            return false;
+        for (std::size_t index = 0; index < changed.size(); index++) {
+            set_added(changed[index], ticks[index * 2]);
+            set_changed(changed[index], ticks[index * 2 + 1]);
+        }
+    }
+    return true;
+}
+
+template <typename ComponentType>
+std::size_t neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::capacity() const {
+    return _components.capacity();
+}
+
+template <typename ComponentType>
+neat::ecs::list_counters neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::counters() const {
+    list_counters counters  = _counters;
+    counters.reserved_bytes = _sparse.capacity() * sizeof(std::size_t) + _entities.capacity() * sizeof(entity_id) + _components.capacity() * sizeof(ComponentType)
+                            + (_added_ticks.capacity() + _changed_ticks.capacity()) * sizeof(tick_type);
+    return counters;
+}
+
+template <typename ComponentType>
+std::tuple<neat::ecs::entity_id, ComponentType*> neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::first() {
+    if (_entities.empty())
+        return {invalid_entity, nullptr};
+    std::size_t index = std::min_element(_entities.begin(), _entities.end()) - _entities.begin();
+    return {_entities[index], &_components[index]};
+}
+
+template <typename ComponentType>
+std::size_t neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::size() const {
+    return _entities.size();
+}
+
+template <typename ComponentType>
+std::span<const neat::ecs::entity_id> neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::entities() const {
+    return _entities;
+}
+
+template <typename ComponentType>
+std::span<ComponentType> neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::components() {
+    return _components;
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::set_added(entity_id entity, tick_type tick) {
+    static_assert(typing::tracks_changes<ComponentType>, "Component type does not track changes.");
+    _added_ticks[_sparse[entity]]   = tick;
+    _changed_ticks[_sparse[entity]] = tick;
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::set_changed(entity_id entity, tick_type tick) {
+    static_assert(typing::tracks_changes<ComponentType>, "Component type does not track changes.");
+    _changed_ticks[_sparse[entity]] = tick;
+}
+
+template <typename ComponentType>
+neat::ecs::tick_type neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::added_tick(entity_id entity) const {
+    static_assert(typing::tracks_changes<ComponentType>, "Component type does not track changes.");
+    return _added_ticks[_sparse[entity]];
+}
+
+template <typename ComponentType>
+neat::ecs::tick_type neat::ecs::componentlist<ComponentType, neat::ecs::sparse_storage>::changed_tick(entity_id entity) const {
+    static_assert(typing::tracks_changes<ComponentType>, "Component type does not track changes.");
+    return _changed_ticks[_sparse[entity]];
+}
+
+template <typename ComponentType>
+neat::ecs::componentlist<ComponentType, neat::ecs::tag_storage>::componentlist(std::pmr::memory_resource* resource)
+    : _tags(resource) {
+    static_assert(std::is_empty_v<ComponentType>, "Tag storage requires an empty component type.");
+    static_assert(std::is_default_constructible_v<ComponentType>, "Tag component type does not have a default constructor.");
+    static_assert(!typing::tracks_changes<ComponentType>, "Change detection is not supported for tag components.");
+}
+
+template <typename ComponentType>
+neat::ecs::componentlist<ComponentType, neat::ecs::tag_storage>::~componentlist() {}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::tag_storage>::has(entity_id entity) const {
+    if (entity >= _tags.size())
+        return false;
+    return _tags.test(entity);
+}
+
+template <typename ComponentType>
+ComponentType* neat::ecs::componentlist<ComponentType, neat::ecs::tag_storage>::get(entity_id entity) {
+    if (!has(entity))
+        return nullptr;
+    return &_instance;
+}
+
+template <typename ComponentType>
+template <typename... Args>
+ComponentType* neat::ecs::componentlist<ComponentType, neat::ecs::tag_storage>::add(entity_id entity, Args&&...) {
+    static_assert(std::is_constructible_v<ComponentType, Args...>, "Component type can't be built from given arguments.");
+    if (entity >= _tags.size())
+        _tags.resize(entity + 1);
+    if (!_tags.test(entity)) {
+        _tags.set(entity);
+        _count++;
+        if constexpr (profiling)
+            _counters.adds++;
+    }
+    return &_instance;
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::tag_storage>::remove(entity_id entity) {
+    if (!has(entity))
+        return false;
+    _tags.reset(entity);
+    _count--;
+    if constexpr (profiling)
+        _counters.removes++;
+    return true;
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::tag_storage>::allocate(size_t new_count) {
+    if (new_count < _tags.size()) {
+        return false;
+    }
+    _tags.resize(new_count);
+    return true;
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::tag_storage>::shrink_to_fit() {
+    std::size_t last = _tags.find_last();
+    _tags.resize(last < _tags.size() ? last + 1 : 0);
+    _tags.shrink_to_fit();
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::tag_storage>::compact(std::span<const entity_id> remap, std::size_t count) {
+    for (entity_id entity = _tags.find_next(0); entity < _tags.size(); entity = _tags.find_next(entity + 1)) {
+        _tags.reset(entity);
+        _tags.set(remap[entity]);
+    }
+    _tags.resize(std::min(_tags.size(), count));
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::tag_storage>::clear() {
+    std::size_t size = _tags.size();
+    _tags.resize(0);
+    _tags.resize(size);
+    _count = 0;
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::tag_storage>::save(snapshot_writer& out) const {
+    std::size_t last = _tags.find_last();
+    out.bits(_tags, last < _tags.size() ? last + 1 : 0);
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::tag_storage>::restore(snapshot_reader& in, std::size_t capacity) {
+    clear();
+    std::size_t size = _tags.size();
+    if (!in.bits(_tags) || _tags.size() > capacity) {
+        _tags.resize(0);
+        _tags.resize(size);
+        return false;
+    }
+    _tags.resize(std::max(_tags.size(), size));
+    _count = _tags.count();
+    return true;
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::tag_storage>::diff(const componentlist& base, const bitset& alive, snapshot_writer& out) const {
+    std::vector<entity_id> removed;
+    for (entity_id entity = base._tags.find_next(0); entity < base._tags.size(); entity = base._tags.find_next(entity + 1)) {
+        if (!has(entity) && entity < alive.size() && alive.test(entity))
+            removed.push_back(entity);
+    }
+    std::vector<entity_id> added;
+    for (entity_id entity = _tags.find_next(0); entity < _tags.size(); entity = _tags.find_next(entity + 1)) {
+        if (!base.has(entity))
+            added.push_back(entity);
+    }
+    out.array(removed.data(), removed.size() * sizeof(entity_id));
+    out.array(added.data(), added.size() * sizeof(entity_id));
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::tag_storage>::apply(snapshot_reader& in, std::size_t capacity, std::vector<entity_id>& touched) {
+    std::vector<entity_id> removed = in.values<entity_id>();
+    std::vector<entity_id> added   = in.values<entity_id>();
+    if (in.failed() || std::ranges::any_of(added, [capacity](entity_id entity) { return entity >= capacity; }))
+        return false;
+    for (entity_id entity : removed) {
+        if (remove(entity))
+            touched.push_back(entity);
+    }
+    for (entity_id entity : added) {
+        add(entity);
+        touched.push_back(entity);
+    }
+    return true;
+}
+
+template <typename ComponentType>
+std::size_t neat::ecs::componentlist<ComponentType, neat::ecs::tag_storage>::capacity() const {
+    return _tags.size();
+}
+
+template <typename ComponentType>
+neat::ecs::list_counters neat::ecs::componentlist<ComponentType, neat::ecs::tag_storage>::counters() const {
+    list_counters counters  = _counters;
+    counters.reserved_bytes = _tags.reserved_bytes();
+    return counters;
+}
+
+template <typename ComponentType>
+std::tuple<neat::ecs::entity_id, ComponentType*> neat::ecs::componentlist<ComponentType, neat::ecs::tag_storage>::first() {
+    entity_id entity = _tags.find_next(0);
+    if (entity >= _tags.size())
+        return {invalid_entity, nullptr};
+    return {entity, &_instance};
+}
+
+template <typename ComponentType>
+std::size_t neat::ecs::componentlist<ComponentType, neat::ecs::tag_storage>::size() const {
+    return _count;
+}
+
+template <typename ComponentType>
+const neat::ecs::bitset& neat::ecs::componentlist<ComponentType, neat::ecs::tag_storage>::tags() const {
+    return _tags;
+}
+
+template <typename ComponentType>
+neat::ecs::componentlist<ComponentType, neat::ecs::singleton_storage>::componentlist(std::pmr::memory_resource*) {
+    static_assert(std::is_class_v<ComponentType>, "Component type is not a struct or class.");
+    static_assert(!typing::tracks_changes<ComponentType>, "Change detection is not supported for singleton components.");
+}
+
+template <typename ComponentType>
+neat::ecs::componentlist<ComponentType, neat::ecs::singleton_storage>::~componentlist() {}
+
+template <typename ComponentType>
+template <typename... Args>
+ComponentType* neat::ecs::componentlist<ComponentType, neat::ecs::singleton_storage>::set(Args&&... args) {
+    static_assert(std::is_constructible_v<ComponentType, Args...>, "Component type can't be built from given arguments.");
+    // The arguments may refer to the current value, so the new value is built before it is replaced
+    ComponentType value(std::forward<Args>(args)...);
+    _value.reset();
+    if constexpr (profiling)
+        _counters.adds++;
+    return &_value.emplace(std::move(value));
+}
+
+template <typename ComponentType>
+ComponentType* neat::ecs::componentlist<ComponentType, neat::ecs::singleton_storage>::get() {
+    return _value ? &*_value : nullptr;
+}
+
+template <typename ComponentType>
+ComponentType* neat::ecs::componentlist<ComponentType, neat::ecs::singleton_storage>::get(entity_id) {
+    return get();
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::singleton_storage>::has(entity_id) const {
+    return false;
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::singleton_storage>::remove(entity_id) {
+    return false;
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::singleton_storage>::reset() {
+    if (!_value)
+        return false;
+    _value.reset();
+    if constexpr (profiling)
+        _counters.removes++;
+    return true;
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::singleton_storage>::allocate(size_t) {
+    return false;
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::singleton_storage>::compact(std::span<const entity_id>, std::size_t) {}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::singleton_storage>::shrink_to_fit() {}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::singleton_storage>::clear() {
+    _value.reset();
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::singleton_storage>::save(snapshot_writer& out) const {
+    static_assert(typing::raw_snapshot<ComponentType> || typing::custom_snapshot<ComponentType>, "Component type is not trivially copyable and has no save and load functions in its traits.");
+    out.value<std::uint64_t>(_value ? 1 : 0);
+    if (!_value)
+        return;
+    if constexpr (typing::raw_snapshot<ComponentType>) {
+        out.array(&*_value, sizeof(ComponentType));
+    } else {
+        out.blob([this](std::ostream& stream) { component_traits<ComponentType>::save(stream, *_value); });
+    }
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::singleton_storage>::restore(snapshot_reader& in, std::size_t) {
+    clear();
+    if (in.value<std::uint64_t>() == 0)
+        return !in.failed();
+    if constexpr (typing::raw_snapshot<ComponentType>) {
+        std::span<const std::byte> value = in.array();
+        if (in.failed() || value.size() != sizeof(ComponentType))
+            return false;
+        std::array<std::byte, sizeof(ComponentType)> bytes;
+        std::memcpy(bytes.data(), value.data(), sizeof(ComponentType));
+        _value.emplace(std::bit_cast<ComponentType>(bytes));
+        return true;
+    } else {
+        return in.blob([this](std::istream& stream) { _value.emplace(component_traits<ComponentType>::load(stream)); });
+    }
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::singleton_storage>::diff(const componentlist& base, const bitset&, snapshot_writer& out) const {
+    static_assert(typing::raw_snapshot<ComponentType> || typing::custom_snapshot<ComponentType>, "Component type is not trivially copyable and has no save and load functions in its traits.");
+    // Unchanged, set or reset
+    if (!_value) {
+        out.value<std::uint64_t>(base._value ? 2 : 0);
+    } else if (base._value && typing::same_snapshot(*_value, *base._value)) {
+        out.value<std::uint64_t>(0);
+    } else {
+        out.value<std::uint64_t>(1);
+        out.components<ComponentType>(1, [this](std::size_t) -> const ComponentType& { return *_value; });
+    }
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::singleton_storage>::apply(snapshot_reader& in, std::size_t, std::vector<entity_id>&) {
+    std::uint64_t state = in.value<std::uint64_t>();
+    if (state == 2)
+        _value.reset();
+    if (state == 1)
+        return in.components<ComponentType>(1, [this](std::size_t, ComponentType&& component) { _value.emplace(std::move(component)); });
+    return !in.failed() && state <= 2;
+}
+
+template <typename ComponentType>
+std::size_t neat::ecs::componentlist<ComponentType, neat::ecs::singleton_storage>::size() const {
+    return _value ? 1 : 0;
+}
+
+template <typename ComponentType>
+std::size_t neat::ecs::componentlist<ComponentType, neat::ecs::singleton_storage>::capacity() const {
+    return 1;
+}
+
+template <typename ComponentType>
+neat::ecs::list_counters neat::ecs::componentlist<ComponentType, neat::ecs::singleton_storage>::counters() const {
+    list_counters counters  = _counters;
+    counters.reserved_bytes = sizeof(_value);
+    return counters;
+}
+
+template <typename ComponentType>
+neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::componentlist(std::pmr::memory_resource* resource)
+    : _tags(resource), _fields(typing::unpack<typename fields_type::arrays>::apply([resource]<typename... Arrays>() { return typename fields_type::arrays(Arrays(resource)...); })) {
+    static_assert(std::is_class_v<ComponentType>, "Component type is not a struct or class.");
+    static_assert(std::is_default_constructible_v<ComponentType>, "Struct-of-arrays component type does not have a default constructor.");
+    static_assert(!typing::tracks_changes<ComponentType>, "Change detection is not supported for struct-of-arrays components.");
+}
+
+template <typename ComponentType>
+neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::~componentlist() {}
+
+template <typename ComponentType>
+template <typename Function>
+void neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::_for_each_field(Function&& function) {
+    [&]<std::size_t... Index>(std::index_sequence<Index...>) {
+        (function(std::integral_constant<std::size_t, Index> {}), ...);
+    }(std::make_index_sequence<fields_type::count> {});
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::has(entity_id entity) const {
+    if (entity >= _tags.size())
+        return false;
+    return _tags.test(entity);
+}
+
+template <typename ComponentType>
+neat::ecs::soa_pointer<ComponentType> neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::get(entity_id entity) {
+    if (!has(entity))
+        return nullptr;
+    return {this, entity};
+}
+
+template <typename ComponentType>
+template <typename... Args>
+neat::ecs::soa_pointer<ComponentType> neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::add(entity_id entity, Args&&... args) {
+    static_assert(std::is_constructible_v<ComponentType, Args...>, "Component type can't be built from given arguments.");
+    std::size_t capacity = std::get<0>(_fields).size();
+    if (entity >= capacity)
+        allocate(std::max(entity + 1, capacity * 2));
+    if (entity >= _tags.size())
+        _tags.resize(entity + 1);
+
+    // The component is built as a whole, and then scattered over the field arrays
+    store(entity, ComponentType(std::forward<Args>(args)...));
+    if (!_tags.test(entity)) {
+        _tags.set(entity);
+        _count++;
+    }
+    if constexpr (profiling)
+        _counters.adds++;
+    return {this, entity};
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::remove(entity_id entity) {
+    if (!has(entity))
+        return false;
+    _tags.reset(entity);
+    _count--;
+    _for_each_field([&](auto index) {
+        auto& field = std::get<index>(_fields)[entity];
+        field       = std::remove_reference_t<decltype(field)> {};
+    });
+    if constexpr (profiling)
+        _counters.removes++;
+    return true;
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::allocate(size_t new_count) {
+    if (new_count < _tags.size()) {
+        return false;
+    }
+    if constexpr (profiling)
+        _counters.resizes += new_count > std::get<0>(_fields).size();
+    _for_each_field([&](auto index) {
+        auto& field = std::get<index>(_fields);
+        if (new_count > field.size())
+            field.resize(new_count);
+    });
+    _tags.resize(new_count);
+    return true;
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::shrink_to_fit() {
+    std::size_t last  = _tags.find_last();
+    std::size_t count = last < _tags.size() ? last + 1 : 0;
+    _tags.resize(count);
+    _tags.shrink_to_fit();
+    _for_each_field([&](auto index) {
+        auto& field = std::get<index>(_fields);
+        field.resize(std::min(field.size(), count));
+        field.shrink_to_fit();
+    });
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::compact(std::span<const entity_id> remap, std::size_t count) {
+    for (entity_id entity = _tags.find_next(0); entity < _tags.size(); entity = _tags.find_next(entity + 1)) {
+        entity_id target = remap[entity];
+        if (target == entity)
+            continue;
+        _for_each_field([&](auto index) {
+            auto& field   = std::get<index>(_fields);
+            field[target] = std::move(field[entity]);
+            field[entity] = std::remove_reference_t<decltype(field[entity])> {};
+        });
+        _tags.reset(entity);
+        _tags.set(target);
+    }
+    _tags.resize(std::min(_tags.size(), count));
+    _for_each_field([&](auto index) {
+        auto& field = std::get<index>(_fields);
+        field.resize(std::min(field.size(), count));
+        field.shrink_to_fit();
+    });
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::clear() {
+    for (entity_id entity = _tags.find_next(0); entity < _tags.size(); entity = _tags.find_next(entity + 1)) {
+        remove(entity);
+    }
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::save(snapshot_writer& out) const {
+    constexpr bool raw = fields_type::trivially_copyable && !typing::custom_snapshot<ComponentType>;
+    static_assert(raw || typing::custom_snapshot<ComponentType>, "Struct-of-arrays component type has fields which are not trivially copyable, and no save and load functions in its traits.");
+    std::size_t last   = _tags.find_last();
+    std::size_t extent = last < _tags.size() ? last + 1 : 0;
+    out.bits(_tags, extent);
+
+    // Slots without a component hold value-initialized fields, so the field arrays are written as a whole
+    if constexpr (raw) {
+        _for_each_field([&](auto index) {
+            const auto& field = std::get<index>(_fields);
+            out.array(field.data(), extent * sizeof(field[0]));
+        });
+    } else {
+        out.blob([this, extent](std::ostream& stream) {
+            for (entity_id entity = _tags.find_next(0); entity < extent; entity = _tags.find_next(entity + 1)) {
+                component_traits<ComponentType>::save(stream, load(entity));
+            }
+        });
+    }
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::restore(snapshot_reader& in, std::size_t capacity) {
+    constexpr bool raw = fields_type::trivially_copyable && !typing::custom_snapshot<ComponentType>;
+    clear();
+    bitset tags(std::get<0>(_fields).get_allocator().resource());
+    if (!in.bits(tags) || tags.size() > capacity)
+        return false;
+    std::size_t extent = tags.size();
+    allocate(std::max(_tags.size(), extent));
+
+    if constexpr (raw) {
+        bool valid = true;
+        _for_each_field([&](auto index) {
+            auto&                      field = std::get<index>(_fields);
+            std::span<const std::byte> bytes = in.array();
+            valid = valid && !in.failed() && bytes.size() == extent * sizeof(field[0]);
+            if (valid && extent > 0)
+                std::memcpy(field.data(), bytes.data(), bytes.size());
+        });
+        if (!valid)
+            return false;
+        for (entity_id entity = tags.find_next(0); entity < extent; entity = tags.find_next(entity + 1)) {
+            _tags.set(entity);
+            _count++;
+        }
+        return true;
+    } else {
+        return in.blob([this, &tags, extent](std::istream& stream) {
+            for (entity_id entity = tags.find_next(0); entity < extent && stream; entity = tags.find_next(entity + 1)) {
+                add(entity, component_traits<ComponentType>::load(stream));
+            }
+        });
+    }
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::diff(const componentlist& base, const bitset& alive, snapshot_writer& out) const {
+    static_assert(typing::raw_snapshot<ComponentType> || typing::custom_snapshot<ComponentType>, "Struct-of-arrays component type is not trivially copyable and has no save and load functions in its traits.");
+    std::vector<entity_id> removed;
+    for (entity_id entity = base._tags.find_next(0); entity < base._tags.size(); entity = base._tags.find_next(entity + 1)) {
+        if (!has(entity) && entity < alive.size() && alive.test(entity))
+            removed.push_back(entity);
+    }
+    std::vector<entity_id> changed;
+    for (entity_id entity = _tags.find_next(0); entity < _tags.size(); entity = _tags.find_next(entity + 1)) {
+        if (!base.has(entity) || !typing::same_snapshot(load(entity), base.load(entity)))
+            changed.push_back(entity);
+    }
+
+    // Changed components are gathered from their fields and sent whole
+    out.array(removed.data(), removed.size() * sizeof(entity_id));
+    out.array(changed.data(), changed.size() * sizeof(entity_id));
+    out.components<ComponentType>(changed.size(), [this, &changed](std::size_t index) { return load(changed[index]); });
+}
+
+template <typename ComponentType>
+bool neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::apply(snapshot_reader& in, std::size_t capacity, std::vector<entity_id>& touched) {
+    std::vector<entity_id> removed = in.values<entity_id>();
+    std::vector<entity_id> changed = in.values<entity_id>();
+    if (in.failed() || std::ranges::any_of(changed, [capacity](entity_id entity) { return entity >= capacity; }))
+        return false;
+    for (entity_id entity : removed) {
+        if (remove(entity))
+            touched.push_back(entity);
+    }
+    bool loaded = in.components<ComponentType>(changed.size(), [this, &changed](std::size_t index, ComponentType&& component) {
+        add(changed[index], std::move(component));
+    });
+    touched.insert(touched.end(), changed.begin(), changed.end());
+    return loaded;
+}
+
+template <typename ComponentType>
+std::tuple<neat::ecs::entity_id, neat::ecs::soa_pointer<ComponentType>> neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::first() {
+    entity_id entity = _tags.find_next(0);
+    if (entity >= _tags.size())
+        return {invalid_entity, nullptr};
+    return {entity, soa_pointer<ComponentType>(this, entity)};
+}
+
+template <typename ComponentType>
+std::size_t neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::size() const {
+    return _count;
+}
+
+template <typename ComponentType>
+std::size_t neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::capacity() const {
+    return std::get<0>(_fields).size();
+}
+
+template <typename ComponentType>
+neat::ecs::list_counters neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::counters() const {
+    list_counters counters  = _counters;
+    counters.reserved_bytes = _tags.reserved_bytes();
+    _for_each_field([&](auto index) {
+        const auto& field = std::get<index>(_fields);
+        counters.reserved_bytes += field.capacity() * sizeof(field[0]);
+    });
+    return counters;
+}
+
+template <typename ComponentType>
+const neat::ecs::bitset& neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::tags() const {
+    return _tags;
+}
+
+template <typename ComponentType>
+typename neat::ecs::typing::fields_of<ComponentType>::spans neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::fields() {
+    return std::apply([](auto&... arrays) { return typename fields_type::spans(arrays...); }, _fields);
+}
+
+template <typename ComponentType>
+ComponentType neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::load(entity_id entity) const {
+    ComponentType value {};
+    _for_each_field([&](auto index) {
+        value.*std::get<index>(_members) = std::get<index>(_fields)[entity];
+    });
+    return value;
+}
+
+template <typename ComponentType>
+void neat::ecs::componentlist<ComponentType, neat::ecs::soa_storage>::store(entity_id entity, ComponentType&& value) {
+    _for_each_field([&](auto index) {
+        std::get<index>(_fields)[entity] = std::move(value.*std::get<index>(_members));
+    });
+}
+
+#pragma endregion componentlist implementations
+
+#pragma region soa_pointer implementations
+
+template <typename ComponentType>
+neat::ecs::soa_pointer<ComponentType>::soa_pointer(std::nullptr_t) {}
+
+template <typename ComponentType>
+neat::ecs::soa_pointer<ComponentType>::soa_pointer(list_type* list, entity_id entity)
+    : _list(list), _entity(entity) {}
+
+template <typename ComponentType>
+template <typename OtherComponent>
+    requires std::is_same_v<const OtherComponent, ComponentType>
+neat::ecs::soa_pointer<ComponentType>::soa_pointer(const soa_pointer<OtherComponent>& other)
+    : _list(other._list), _entity(other._entity) {}
+
+template <typename ComponentType>
+template <auto Field>
+decltype(auto) neat::ecs::soa_pointer<ComponentType>::get() const {
+    constexpr std::size_t index = typing::field_index<std::remove_const_t<ComponentType>, Field>();
+    static_assert(index != SIZE_MAX, "Requested field is not listed in the component traits.");
+    auto& field = std::get<index>(_list->_fields)[_entity];
+    if constexpr (std::is_const_v<ComponentType>)
+        return std::as_const(field);
+    else
+        return (field);
+}
+
+template <typename ComponentType>
+std::remove_const_t<ComponentType> neat::ecs::soa_pointer<ComponentType>::load() const {
+    return _list->load(_entity);
+}
+
+template <typename ComponentType>
+void neat::ecs::soa_pointer<ComponentType>::store(std::remove_const_t<ComponentType> value) const
+    requires(!std::is_const_v<ComponentType>)
+{
+    _list->store(_entity, std::move(value));
+}
+
+template <typename ComponentType>
+neat::ecs::entity_id neat::ecs::soa_pointer<ComponentType>::entity() const {
+    return _entity;
+}
+
+template <typename ComponentType>
+neat::ecs::soa_pointer<ComponentType>::operator bool() const {
+    return _list != nullptr;
+}
+
+template <typename ComponentType>
+bool neat::ecs::soa_pointer<ComponentType>::operator==(std::nullptr_t) const {
+    return _list == nullptr;
+}
+
+#pragma endregion soa_pointer implementations
+
+#pragma region view implementations
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+neat::ecs::view<Engine, WithEntity, RequestedComponents...>::view(Engine& ecs, tick_type since)
+    : _ecs(&ecs), _since(since) {}
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+neat::ecs::view<Engine, WithEntity, RequestedComponents...>::view(Engine& ecs, std::size_t first, std::size_t last)
+    : _ecs(&ecs), _first(first), _last(last) {}
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+typename neat::ecs::view<Engine, WithEntity, RequestedComponents...>::iterator neat::ecs::view<Engine, WithEntity, RequestedComponents...>::begin() const {
+    return _make_iterator(false);
+}
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+typename neat::ecs::view<Engine, WithEntity, RequestedComponents...>::iterator neat::ecs::view<Engine, WithEntity, RequestedComponents...>::end() const {
+    return _make_iterator(true);
+}
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+typename neat::ecs::view<Engine, WithEntity, RequestedComponents...>::iterator neat::ecs::view<Engine, WithEntity, RequestedComponents...>::_make_iterator(bool at_end) const {
+    // Drive the query from the requested component with the smallest population, and only probe the other
+    // components for the entities of the driver
+    const entity_id* packed     = nullptr;
+    const bitset*    tags       = nullptr;
+    std::size_t      driver     = SIZE_MAX;
+    std::size_t      population = SIZE_MAX;
+    std::size_t      end        = _ecs->_entity_capacity();
+    typing::unpack<required>::apply([&]<typename... Required>() {
+        [[maybe_unused]] std::size_t index = 0;
+        ([&] {
+            auto& list = _ecs->template _get_components_list<Required>();
+            if (list.size() < population) {
+                population = list.size();
+                driver     = index;
+                if constexpr (typing::is_sparse<Required>) {
+                    packed = list.entities().data();
+                    tags   = nullptr;
+                } else {
+                    packed = nullptr;
+                    tags   = &list.tags();
+                }
+            }
+            index++;
+        }(),
+         ...);
+    });
+
+    // Queries receiving a singleton which is not set are empty
+    bool missing = typing::unpack<typename query::singletons>::apply([this]<typename... Singletons>() {
+        return ((_ecs->template _get_components_list<Singletons>().get() == nullptr) || ...);
+    });
+
+    if (missing) {
+        end = 0;
+    } else if (packed != nullptr) {
+        end = population;
+    } else if (population == 0) {
+        end = 0;
+    } else if constexpr (!typing::any_sparse<required> && std::tuple_size_v<required> > 1) {
+        // If the driver has more than one entity per bitset word on average, intersecting the bitsets is cheaper
+        if (population * bitset::word_bits >= end) {
+            tags   = nullptr;
+            driver = SIZE_MAX;
+        }
+    }
+    end = std::min(end, _last);
+    return iterator(_ecs, packed, tags, driver, at_end ? end : std::min(_first, end), end, _since);
+}
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+std::size_t neat::ecs::view<Engine, WithEntity, RequestedComponents...>::_cursor_end() const {
+    return _make_iterator(true)._end;
+}
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+neat::ecs::view<Engine, WithEntity, RequestedComponents...>::iterator::iterator(Engine* ecs, const entity_id* packed, const bitset* tags, std::size_t driver, std::size_t cursor, std::size_t end, tick_type since)
+    : _ecs(ecs), _packed(packed), _tags(tags), _driver(driver), _cursor(cursor), _end(end), _since(since) {
+    _skip_to_match();
+}
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+typename neat::ecs::view<Engine, WithEntity, RequestedComponents...>::iterator::value_type neat::ecs::view<Engine, WithEntity, RequestedComponents...>::iterator::operator*() const {
+    return typing::unpack<typename query::returned>::apply([this]<typename... Returned>() -> value_type {
+        if constexpr (WithEntity)
+            return {_entity, _get_component<std::remove_pointer_t<Returned>>()...};
+        else
+            return {_get_component<std::remove_pointer_t<Returned>>()...};
+    });
+}
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+typename neat::ecs::view<Engine, WithEntity, RequestedComponents...>::iterator& neat::ecs::view<Engine, WithEntity, RequestedComponents...>::iterator::operator++() {
+    _cursor++;
+    _skip_to_match();
+    return *this;
+}
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+typename neat::ecs::view<Engine, WithEntity, RequestedComponents...>::iterator neat::ecs::view<Engine, WithEntity, RequestedComponents...>::iterator::operator++(int) {
+    iterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+bool neat::ecs::view<Engine, WithEntity, RequestedComponents...>::iterator::operator==(const iterator& other) const {
+    return _cursor == other._cursor;
+}
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+void neat::ecs::view<Engine, WithEntity, RequestedComponents...>::iterator::_skip_to_match() {
+    if (_tags != nullptr) {
+        // Walk the entities of the dense driver, probing the other components
+        while (true) {
+            std::size_t next = _tags->find_next(_cursor);
+            _cursor          = next < _tags->size() ? std::min(next, _end) : _end;
+            if (_cursor == _end || _matches(_cursor))
+                break;
+            _cursor++;
+        }
+        _entity = _cursor;
+        return;
+    }
+    if constexpr (!typing::any_sparse<required>) {
+        // Intersect the bitsets of the required components, and apply the other filters to the matches
+        while (true) {
+            std::size_t next = typing::unpack<required>::apply([this]<typename... Required>() {
+                return _ecs->template _find_next_entity_with_components<Required...>(_cursor);
+            });
+            _cursor = std::min(next, _end);
+            if (_cursor == _end || !_is_filtered(_cursor))
+                break;
+            _cursor++;
+        }
+        _entity = _cursor;
+    } else {
+        while (_cursor < _end && !_matches(_packed[_cursor])) {
+            _cursor++;
+        }
+        if (_cursor < _end)
+            _entity = _packed[_cursor];
+    }
+}
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+bool neat::ecs::view<Engine, WithEntity, RequestedComponents...>::iterator::_matches(entity_id entity) const {
+    bool has_required = typing::unpack<required>::apply([this, entity]<typename... Required>() {
+        return _ecs->template _entity_has_components<Required...>(entity);
+    });
+    return has_required && !_is_filtered(entity);
+}
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+bool neat::ecs::view<Engine, WithEntity, RequestedComponents...>::iterator::_is_filtered(entity_id entity) const {
+    // Filters out entities with an excluded component, or with a component which did not change since the tick
+    bool is_excluded = typing::unpack<excluded>::apply([this, entity]<typename... Excluded>() {
+        return (_ecs->template _get_components_list<Excluded>().has(entity) || ...);
+    });
+    bool is_unchanged = typing::unpack<typename query::changed>::apply([this, entity]<typename... Changed>() {
+        return ((_ecs->template _get_components_list<Changed>().changed_tick(entity) <= _since) || ...);
+    });
+    bool is_not_added = typing::unpack<typename query::added>::apply([this, entity]<typename... Added>() {
+        return ((_ecs->template _get_components_list<Added>().added_tick(entity) <= _since) || ...);
+    });
+    return is_excluded || is_unchanged || is_not_added;
+}
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+template <typename RequestedComponent>
+RequestedComponent* neat::ecs::view<Engine, WithEntity, RequestedComponents...>::iterator::_get_component() const {
+    auto& list = _ecs->template _get_components_list<RequestedComponent>();
+    if constexpr (typing::is_sparse<RequestedComponent>) {
+        // The components of the driver are packed in the same order as the entities
+        constexpr std::size_t index = typing::unpack<required>::apply([]<typename... Required>() {
+            if constexpr (typing::is_one_of<RequestedComponent, Required...>)
+                return static_cast<std::size_t>(typing::get_index<RequestedComponent, Required...>());
+            else
+                return SIZE_MAX;
+        });
+        if (_packed != nullptr && index == _driver)
+            return &list.components()[_cursor];
+    }
+    return list.get(_entity);
+}
+
+#pragma endregion view implementations
+
+#pragma region cached query implementations
+
+template <typename Engine, typename... RequestedComponents>
+neat::ecs::cached_query<Engine, RequestedComponents...>::cached_query(Engine& ecs)
+    : _state(std::make_unique<typename Engine::query_state>()) {
+    _state->ecs     = &ecs;
+    _state->matches = &Engine::template _matches<RequestedComponents...>;
+    (_state->components.set(Engine::template _index_of<RequestedComponents>()), ...);
+    for (const auto& item : ecs.template iterate<RequestedComponents...>()) {
+        _state->entities.insert(std::get<0>(item));
+    }
+    ecs._queries.push_back(_state.get());
+}
+
+template <typename Engine, typename... RequestedComponents>
+neat::ecs::cached_query<Engine, RequestedComponents...>& neat::ecs::cached_query<Engine, RequestedComponents...>::operator=(cached_query&& other) noexcept {
+    if (this != &other) {
+        _unregister();
+        _state = std::move(other._state);
+    }
+    return *this;
+}
+
+template <typename Engine, typename... RequestedComponents>
+neat::ecs::cached_query<Engine, RequestedComponents...>::~cached_query() {
+    _unregister();
+}
+
+template <typename Engine, typename... RequestedComponents>
+typename neat::ecs::cached_query<Engine, RequestedComponents...>::iterator neat::ecs::cached_query<Engine, RequestedComponents...>::begin() const {
+    return iterator(_state->ecs, _state->entities.entities().data(), 0);
+}
+
+template <typename Engine, typename... RequestedComponents>
+typename neat::ecs::cached_query<Engine, RequestedComponents...>::iterator neat::ecs::cached_query<Engine, RequestedComponents...>::end() const {
+    return iterator(_state->ecs, _state->entities.entities().data(), _state->entities.size());
+}
+
+template <typename Engine, typename... RequestedComponents>
+std::size_t neat::ecs::cached_query<Engine, RequestedComponents...>::size() const {
+    return _state->entities.size();
+}
+
+template <typename Engine, typename... RequestedComponents>
+std::span<const neat::ecs::entity_id> neat::ecs::cached_query<Engine, RequestedComponents...>::entities() const {
+    return _state->entities.entities();
+}
+
+template <typename Engine, typename... RequestedComponents>
+void neat::ecs::cached_query<Engine, RequestedComponents...>::_unregister() {
+    if (_state == nullptr || _state->ecs == nullptr)
+        return;
+    auto& queries = _state->ecs->_queries;
+    queries.erase(std::find(queries.begin(), queries.end(), _state.get()));
+}
+
+template <typename Engine, typename... RequestedComponents>
+neat::ecs::cached_query<Engine, RequestedComponents...>::iterator::iterator(Engine* ecs, const entity_id* entities, std::size_t index)
+    : _ecs(ecs), _entities(entities), _index(index) {}
+
+template <typename Engine, typename... RequestedComponents>
+typename neat::ecs::cached_query<Engine, RequestedComponents...>::iterator::value_type neat::ecs::cached_query<Engine, RequestedComponents...>::iterator::operator*() const {
+    entity_id entity = _entities[_index];
+    return {entity, _ecs->template _get_components_list<RequestedComponents>().get(entity)...};
+}
+
+template <typename Engine, typename... RequestedComponents>
+typename neat::ecs::cached_query<Engine, RequestedComponents...>::iterator& neat::ecs::cached_query<Engine, RequestedComponents...>::iterator::operator++() {
+    _index++;
+    return *this;
+}
+
+template <typename Engine, typename... RequestedComponents>
+typename neat::ecs::cached_query<Engine, RequestedComponents...>::iterator neat::ecs::cached_query<Engine, RequestedComponents...>::iterator::operator++(int) {
+    iterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+template <typename Engine, typename... RequestedComponents>
+bool neat::ecs::cached_query<Engine, RequestedComponents...>::iterator::operator==(const iterator& other) const {
+    return _index == other._index;
+}
+
+#pragma endregion cached query implementations
+
+#pragma region ecs implementations
+
+template <typename... RegisteredComponents>
+neat::ecs::engine<RegisteredComponents...>::engine(std::pmr::memory_resource* resource)
+    : entities(*this, resource), components(*this, resource), systems(*this), scheduler(*this), _queries(resource) {
+    static_assert(typing::are_unique_types<RegisteredComponents...>, "Not all registered component types are unique.");
+    static_assert(typing::are_all_classes<RegisteredComponents...>, "All registered component types must be a struct or a class.");
+}
+
+template <typename... RegisteredComponents>
+neat::ecs::engine<RegisteredComponents...>::engine::~engine() {
+    // Cached queries can outlive the engine, they should no longer unregister themselves
+    for (query_state* query : _queries) {
+        query->ecs = nullptr;
+    }
+}
+
+template <typename... RegisteredComponents>
+template <typename... RequestedComponents>
+neat::ecs::view<neat::ecs::engine<RegisteredComponents...>, true, RequestedComponents...> neat::ecs::engine<RegisteredComponents...>::iterate(tick_type since) {
+    static_assert(typing::query<RequestedComponents...>::template is_registered<RegisteredComponents...>, "At least one of the requested components is not registered.");
+    return view<engine, true, RequestedComponents...>(*this, since);
+}
+
+template <typename... RegisteredComponents>
+template <typename... RequestedComponents>
+neat::ecs::view<neat::ecs::engine<RegisteredComponents...>, false, RequestedComponents...> neat::ecs::engine<RegisteredComponents...>::iterate_components(tick_type since) {
+    static_assert(typing::query<RequestedComponents...>::template is_registered<RegisteredComponents...>, "At least one of the requested components is not registered.");
+    return view<engine, false, RequestedComponents...>(*this, since);
+}
+
+template <typename... RegisteredComponents>
+neat::ecs::tick_type neat::ecs::engine<RegisteredComponents...>::current_tick() const {
+    return _tick;
+}
+
+template <typename... RegisteredComponents>
+neat::ecs::tick_type neat::ecs::engine<RegisteredComponents...>::advance_tick() {
+    return ++_tick;
+}
+
+template <typename... RegisteredComponents>
+template <typename... RequestedComponents>
+neat::ecs::cached_query<neat::ecs::engine<RegisteredComponents...>, RequestedComponents...> neat::ecs::engine<RegisteredComponents...>::cache() {
+    static_assert(typing::is_subset_of<std::tuple<std::remove_const_t<RequestedComponents>...>, std::tuple<RegisteredComponents...>>, "At least one of the requested components is not registered.");
+    static_assert(!(typing::is_singleton<RequestedComponents> || ...), "Singleton components can not be cached, use components.get instead.");
+    return cached_query<engine, RequestedComponents...>(*this);
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent>
+constexpr std::size_t neat::ecs::engine<RegisteredComponents...>::_index_of() {
+    static_assert(typing::is_one_of<std::remove_const_t<RequestedComponent>, RegisteredComponents...>, "Requested component type is not registered.");
+    return typing::get_index<std::remove_const_t<RequestedComponent>, RegisteredComponents...>();
+}
+
+template <typename... RegisteredComponents>
+template <typename... RequestedComponents>
+bool neat::ecs::engine<RegisteredComponents...>::_matches(engine& ecs, entity_id entity) {
+    return ecs._entity_has_components<RequestedComponents...>(entity);
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent>
+void neat::ecs::engine<RegisteredComponents...>::_on_component_added(entity_id entity) {
+    if constexpr (typing::tracks_changes<RequestedComponent>)
+        _get_components_list<RequestedComponent>().set_added(entity, _tick);
+
+    constexpr std::size_t index = _index_of<RequestedComponent>();
+    for (query_state* query : _queries) {
+        if (query->components.test(index) && !query->entities.contains(entity) && query->matches(*this, entity))
+            query->entities.insert(entity);
+    }
+}
+
+template <typename... RegisteredComponents>
+template <typename... RequestedComponents>
+void neat::ecs::engine<RegisteredComponents...>::_mark_written(entity_id entity) {
+    // Components requested through a pointer to non-const can be modified, and are considered changed
+    ([&] {
+        if constexpr (typing::tracks_changes<RequestedComponents> && !std::is_const_v<RequestedComponents>)
+            _get_components_list<RequestedComponents>().set_changed(entity, _tick);
+    }(),
+     ...);
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent>
+void neat::ecs::engine<RegisteredComponents...>::_on_component_removed(entity_id entity) {
+    constexpr std::size_t index = _index_of<RequestedComponent>();
+    for (query_state* query : _queries) {
+        if (query->components.test(index))
+            query->entities.erase(entity);
+    }
+}
+
+template <typename... RegisteredComponents>
+void neat::ecs::engine<RegisteredComponents...>::_on_entity_created(entity_id entity) {
+    for (query_state* query : _queries) {
+        if (query->components.none())
+            query->entities.insert(entity);
+    }
+}
+
+template <typename... RegisteredComponents>
+void neat::ecs::engine<RegisteredComponents...>::_on_entity_removed(entity_id entity) {
+    for (query_state* query : _queries) {
+        query->entities.erase(entity);
+    }
+}
+
+template <typename... RegisteredComponents>
+neat::ecs::entity_id neat::ecs::engine<RegisteredComponents...>::_entity_capacity() const {
+    return entities._entities.size();
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent>
+neat::ecs::componentlist<std::remove_const_t<RequestedComponent>>& neat::ecs::engine<RegisteredComponents...>::_get_components_list() {
+    static_assert(typing::is_one_of<std::remove_const_t<RequestedComponent>, RegisteredComponents...>, "Requested component type is not registered.");
+    return std::get<typing::get_index<std::remove_const_t<RequestedComponent>, RegisteredComponents...>()>(components._components);
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent>
+void neat::ecs::engine<RegisteredComponents...>::_grow_components(entity_id last) {
+    // Grows geometrically like adding a single component, so that repeated bulk additions don't relocate the list every time
+    auto& list = _get_components_list<RequestedComponent>();
+    if (last >= list.capacity())
+        list.allocate(std::max<std::size_t>(last + 1, list.capacity() * 2));
+}
+
+template <typename... RegisteredComponents>
+template <typename... RequestedComponents>
+bool neat::ecs::engine<RegisteredComponents...>::_entity_has_components([[maybe_unused]] entity_id entity) {
+    return (_get_components_list<RequestedComponents>().has(entity) && ...);
+}
+
+template <typename... RegisteredComponents>
+template <typename... RequestedComponents>
+neat::ecs::entity_id neat::ecs::engine<RegisteredComponents...>::_find_next_entity_with_components(entity_id from) {
+    static_assert(typing::is_subset_of<std::tuple<std::remove_const_t<RequestedComponents>...>, std::tuple<RegisteredComponents...>>, "At least one of the requested component types is not registered.");
+    if constexpr (sizeof...(RequestedComponents) == 0) {
+        return entities._entities.find_next(from);
+    } else if constexpr (typing::any_sparse<std::tuple<RequestedComponents...>>) {
+        // Sparse components have no tags, the candidates of the other components are probed for them
+        std::array<const bitset*, 1 + (!typing::is_sparse<RequestedComponents> + ...)> sets;
+        std::size_t                                                                    index = 0;
+        sets[index++]                                                                        = &entities._entities;
+        ([&] {
+            if constexpr (!typing::is_sparse<RequestedComponents>)
+                sets[index++] = &_get_components_list<RequestedComponents>().tags();
+        }(),
+         ...);
+
+        entity_id entity = bitset::find_next_common(sets, from);
+        while (entity < entities._entities.size() && !_entity_has_components<RequestedComponents...>(entity)) {
+            entity = bitset::find_next_common(sets, entity + 1);
+        }
+        return entity;
+    } else {
+        // Components are removed together with their entity, so the component tags imply liveness
+        std::array<const bitset*, sizeof...(RequestedComponents)> sets = {&_get_components_list<RequestedComponents>().tags()...};
+        return bitset::find_next_common(sets, from);
+    }
+}
+
+template <typename... RegisteredComponents>
+void neat::ecs::engine<RegisteredComponents...>::save(std::ostream& out) const {
+    snapshot_writer writer(out);
+    _write_header(writer, _snapshot_magic);
+
+    writer.bits(entities._entities, entities._entities.size());
+    writer.value<std::uint64_t>(static_cast<std::uint64_t>(entities._policy));
+    std::vector<entity_id> free_entities(entities._free_entities.begin(), entities._free_entities.end());
+    writer.array(free_entities.data(), free_entities.size() * sizeof(entity_id));
+
+    std::apply([&writer](const auto&... lists) { (lists.save(writer), ...); }, components._components);
+}
+
+template <typename... RegisteredComponents>
+bool neat::ecs::engine<RegisteredComponents...>::restore(std::istream& in) {
+    std::vector<char> snapshot((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return restore(std::as_bytes(std::span<const char>(snapshot)));
+}
+
+template <typename... RegisteredComponents>
+bool neat::ecs::engine<RegisteredComponents...>::restore(std::span<const std::byte> snapshot) {
+    // The header and the entities are validated before anything is replaced
+    snapshot_reader reader(snapshot);
+    if (!_read_header(reader, _snapshot_magic))
+        return false;
+    tick_type tick = reader.value<std::uint64_t>();
+
+    bitset entity_ids(_queries.get_allocator().resource());
+    if (!reader.bits(entity_ids))
+        return false;
+    std::uint64_t              policy        = reader.value<std::uint64_t>();
+    std::span<const std::byte> free_entities = reader.array();
+    if (reader.failed() || policy > static_cast<std::uint64_t>(reuse_policy::lowest_first) || free_entities.size() % sizeof(entity_id) != 0)
+        return false;
+    std::vector<entity_id> free_list(free_entities.size() / sizeof(entity_id));
+    if (!free_list.empty())
+        std::memcpy(free_list.data(), free_entities.data(), free_entities.size());
+    for (entity_id entity : free_list) {
+        if (entity >= entity_ids.size() || entity_ids.test(entity))
+            return false;
+    }
+
+    entities._entities.assign(entity_ids.words(), entity_ids.size());
+    entities._free_entities.assign(free_list.begin(), free_list.end());
+    entities._policy = static_cast<reuse_policy>(policy);
+    _tick            = tick;
+
+    bool restored = std::apply([&reader, capacity = entity_ids.size()](auto&... lists) { return (lists.restore(reader, capacity) && ...); }, components._components);
+    if (!restored) {
+        _clear();
+        return false;
+    }
+
+    for (query_state* query : _queries) {
+        query->entities.clear();
+        for (entity_id entity = entities._entities.find_next(0); entity < entities._entities.size(); entity = entities._entities.find_next(entity + 1)) {
+            if (query->matches(*this, entity))
+                query->entities.insert(entity);
+        }
+    }
+    return true;
+}
+
+template <typename... RegisteredComponents>
+neat::ecs::memory_report neat::ecs::engine<RegisteredComponents...>::memory_stats() const {
+    memory_report report;
+    report.entities        = entities._entities.count();
+    report.entity_capacity = entities._entities.size();
+    report.free_entities   = entities._free_entities.size();
+    report.entity_bytes    = entities._entities.reserved_bytes();
+    report.free_used_bytes = entities._free_entities.size() * sizeof(entity_id);
+    report.bytes           = report.entity_bytes + report.free_used_bytes;
+    std::apply([&report](const auto&... lists) {
+        (report.components.push_back({std::string(typing::type_name<RegisteredComponents>()), lists.capacity(), lists.size(), 0.0, lists.counters().reserved_bytes}), ...);
+    }, components._components);
+    for (component_memory& component : report.components) {
+        if (component.capacity > 0)
+            component.occupancy = static_cast<double>(component.count) / static_cast<double>(component.capacity);
+        report.bytes += component.bytes;
+    }
+    return report;
+}
+
+template <typename... RegisteredComponents>
+void neat::ecs::engine<RegisteredComponents...>::shrink_to_fit() {
+    std::apply([](auto&... lists) { (lists.shrink_to_fit(), ...); }, components._components);
+    entities._free_entities.shrink_to_fit();
+}
+
+template <typename... RegisteredComponents>
+neat::ecs::profile_report neat::ecs::engine<RegisteredComponents...>::profile() const {
+    profile_report report;
+    if constexpr (profiling) {
+        report.systems = _profiler.systems();
+        std::apply([&report](const auto&... lists) {
+            (report.components.push_back({std::string(typing::type_name<RegisteredComponents>()), lists.size(), lists.counters()}), ...);
+        }, components._components);
+    }
+    return report;
+}
+
+template <typename... RegisteredComponents>
+void neat::ecs::engine<RegisteredComponents...>::reset_profile() {
+    _profiler.reset();
+}
+
+template <typename... RegisteredComponents>
+void neat::ecs::engine<RegisteredComponents...>::write_trace(std::ostream& out) const {
+    _profiler.write_trace(out, profile().components);
+}
+
+template <typename... RegisteredComponents>
+void neat::ecs::engine<RegisteredComponents...>::delta(const engine& base, std::ostream& out) const {
+    snapshot_writer writer(out);
+    _write_header(writer, _delta_magic);
+
+    const bitset&          alive      = entities._entities;
+    const bitset&          base_alive = base.entities._entities;
+    std::vector<entity_id> removed;
+    for (entity_id entity = base_alive.find_next(0); entity < base_alive.size(); entity = base_alive.find_next(entity + 1)) {
+        if (entity >= alive.size() || !alive.test(entity))
+            removed.push_back(entity);
+    }
+    std::vector<entity_id> created;
+    for (entity_id entity = alive.find_next(0); entity < alive.size(); entity = alive.find_next(entity + 1)) {
+        if (entity >= base_alive.size() || !base_alive.test(entity))
+            created.push_back(entity);
+    }
+    writer.value<std::uint64_t>(alive.size());
+    writer.array(removed.data(), removed.size() * sizeof(entity_id));
+    writer.array(created.data(), created.size() * sizeof(entity_id));
+    writer.value<std::uint64_t>(static_cast<std::uint64_t>(entities._policy));
+    std::vector<entity_id> free_entities(entities._free_entities.begin(), entities._free_entities.end());
+    writer.array(free_entities.data(), free_entities.size() * sizeof(entity_id));
+
+    [&]<std::size_t... Index>(std::index_sequence<Index...>) {
+        (std::get<Index>(components._components).diff(std::get<Index>(base.components._components), alive, writer), ...);
+    }(std::index_sequence_for<RegisteredComponents...> {});
+}
+
+template <typename... RegisteredComponents>
+bool neat::ecs::engine<RegisteredComponents...>::delta(std::span<const std::byte> base_snapshot, std::ostream& out) const {
+    engine base(_queries.get_allocator().resource());
+    if (!base.restore(base_snapshot))
+        return false;
+    delta(base, out);
+    return true;
+}
+
+template <typename... RegisteredComponents>
+bool neat::ecs::engine<RegisteredComponents...>::apply(std::istream& in) {
+    std::vector<char> delta((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return apply(std::as_bytes(std::span<const char>(delta)));
+}
+
+template <typename... RegisteredComponents>
+bool neat::ecs::engine<RegisteredComponents...>::apply(std::span<const std::byte> delta) {
+    // The delta must start from the current state, which is checked against the created and removed entities
+    snapshot_reader reader(delta);
+    if (!_read_header(reader, _delta_magic))
+        return false;
+    tick_type              tick          = reader.value<std::uint64_t>();
+    std::uint64_t          capacity      = reader.value<std::uint64_t>();
+    std::vector<entity_id> removed       = reader.values<entity_id>();
+    std::vector<entity_id> created       = reader.values<entity_id>();
+    std::uint64_t          policy        = reader.value<std::uint64_t>();
+    std::vector<entity_id> free_entities = reader.values<entity_id>();
+    if (reader.failed() || policy > static_cast<std::uint64_t>(reuse_policy::lowest_first))
+        return false;
+    bitset& alive = entities._entities;
+    if (!std::ranges::all_of(removed, [&alive](entity_id entity) { return entity < alive.size() && alive.test(entity); }))
+        return false;
+    for (entity_id entity : created) {
+        bool removed_first = std::ranges::find(removed, entity) != removed.end();
+        if (entity >= capacity || (entity < alive.size() && alive.test(entity) && !removed_first))
+            return false;
+    }
+    if (!std::ranges::all_of(free_entities, [capacity](entity_id entity) { return entity < capacity; }))
+        return false;
+
+    for (entity_id entity : removed) {
+        entities.remove(entity);
+    }
+    if (alive.find_next(std::min<std::size_t>(capacity, alive.size())) < alive.size()) {
+        _clear();
+        return false;
+    }
+    alive.resize(capacity);
+    for (entity_id entity : created) {
+        alive.set(entity);
+        _on_entity_created(entity);
+    }
+    entities._free_entities.assign(free_entities.begin(), free_entities.end());
+    entities._policy = static_cast<reuse_policy>(policy);
+    _tick            = tick;
+
+    std::vector<entity_id> touched;
+    bool                   applied = std::apply([&reader, &touched, capacity](auto&... lists) { return (lists.apply(reader, capacity, touched) && ...); }, components._components);
+    if (!applied) {
+        _clear();
+        return false;
+    }
+
+    for (query_state* query : _queries) {
+        for (entity_id entity : touched) {
+            if (query->matches(*this, entity))
+                query->entities.insert(entity);
+            else
+                query->entities.erase(entity);
+        }
+    }
+    return true;
+}
+
+template <typename... RegisteredComponents>
+void neat::ecs::engine<RegisteredComponents...>::_write_header(snapshot_writer& writer, const char (&magic)[8]) const {
+    writer.write(magic, sizeof(magic));
+    writer.value<std::uint32_t>(_snapshot_version);
+    writer.value<std::uint32_t>(sizeof...(RegisteredComponents));
+    (writer.value<std::uint64_t>(_snapshot_signature<RegisteredComponents>()), ...);
+    writer.value<std::uint64_t>(_tick);
+}
+
+template <typename... RegisteredComponents>
+bool neat::ecs::engine<RegisteredComponents...>::_read_header(snapshot_reader& reader, const char (&magic)[8]) const {
+    std::span<const std::byte> bytes = reader.read(sizeof(magic));
+    if (reader.failed() || std::memcmp(bytes.data(), magic, sizeof(magic)) != 0)
+        return false;
+    if (reader.value<std::uint32_t>() != _snapshot_version || reader.value<std::uint32_t>() != sizeof...(RegisteredComponents))
+        return false;
+    return ((reader.value<std::uint64_t>() == _snapshot_signature<RegisteredComponents>()) && ...);
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent>
+std::uint64_t neat::ecs::engine<RegisteredComponents...>::_snapshot_signature() {
+    // Snapshots only fit engines which register the same component types, with the same size and storage
+    std::uint64_t storage = typing::is_sparse<RequestedComponent> ? 1 : typing::is_soa<RequestedComponent> ? 2
+                                                                    : typing::is_tag<RequestedComponent>   ? 3
+                                                                    : typing::is_singleton<RequestedComponent> ? 4
+                                                                                                                 : 0;
+    std::uint64_t layout  = sizeof(RequestedComponent) | storage << 32 | std::uint64_t(typing::tracks_changes<RequestedComponent>) << 40;
+
+    // FNV-1a hash of the type name and the layout
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char character : typing::type_name<RequestedComponent>()) {
+        hash = (hash ^ static_cast<unsigned char>(character)) * 1099511628211ull;
+    }
+    for (std::size_t byte = 0; byte < sizeof(layout); byte++) {
+        hash = (hash ^ ((layout >> (byte * 8)) & 0xff)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+template <typename... RegisteredComponents>
+void neat::ecs::engine<RegisteredComponents...>::_clear() {
+    std::apply([](auto&... lists) { (lists.clear(), ...); }, components._components);
+    entities._entities.resize(0);
+    entities._free_entities.clear();
+    for (query_state* query : _queries) {
+        query->entities.clear();
+    }
+}
+
+#pragma endregion ecs implementations
+
+#pragma region ecs entities implementations
+
+template <typename... RegisteredComponents>
+neat::ecs::engine<RegisteredComponents...>::entities::entities(engine& e, std::pmr::memory_resource* resource)
+    : _ecs(e), _entities(resource), _free_entities(resource) {};
+
+template <typename... RegisteredComponents>
+void neat::ecs::engine<RegisteredComponents...>::entities::_push_free(entity_id entity) {
+    _free_entities.push_back(entity);
+    if (_policy == reuse_policy::lowest_first)
+        _sift_up(_free_entities.size() - 1);
+}
+
+template <typename... RegisteredComponents>
+neat::ecs::entity_id neat::ecs::engine<RegisteredComponents...>::entities::_pop_free() {
+    entity_id entity = invalid_entity;
+    switch (_policy) {
+        case reuse_policy::fifo:
+            entity = _free_entities.front();
+            _free_entities.pop_front();
+            break;
+        case reuse_policy::lifo:
+            entity = _free_entities.back();
+            _free_entities.pop_back();
+            break;
+        case reuse_policy::lowest_first:
+            entity                 = _free_entities.front();
+            _free_entities.front() = _free_entities.back();
+            _free_entities.pop_back();
+            _sift_down(0);
+            break;
+    }
+    return entity;
+}
+
+// The min-heap of lowest_first is maintained with unsigned indices, std::push_heap and std::pop_heap trip -Wstrict-overflow
+template <typename... RegisteredComponents>
+void neat::ecs::engine<RegisteredComponents...>::entities::_sift_up(std::size_t index) {
+    while (index > 0) {
+        std::size_t parent = (index - 1) / 2;
+        if (_free_entities[parent] <= _free_entities[index])
+            break;
+        std::swap(_free_entities[parent], _free_entities[index]);
+        index = parent;
+    }
+}
+
+template <typename... RegisteredComponents>
+void neat::ecs::engine<RegisteredComponents...>::entities::_sift_down(std::size_t index) {
+    std::size_t size = _free_entities.size();
+    for (std::size_t child = 2 * index + 1; child < size; child = 2 * index + 1) {
+        if (child + 1 < size && _free_entities[child + 1] < _free_entities[child])
+            child++;
+        if (_free_entities[index] <= _free_entities[child])
+            break;
+        std::swap(_free_entities[index], _free_entities[child]);
+        index = child;
+    }
+}
+
+template <typename... RegisteredComponents>
+neat::ecs::entity_id neat::ecs::engine<RegisteredComponents...>::entities::create() {
+    if (!_free_entities.empty()) {
+        entity_id entity = _pop_free();
+        _entities.set(entity);
+        _ecs._on_entity_created(entity);
+        return entity;
+    }
+
+    entity_id entity = _entities.size();
+    _entities.push_back(true);
+    _ecs._on_entity_created(entity);
+    return entity;
+}
+
+template <typename... RegisteredComponents>
+std::vector<neat::ecs::entity_id> neat::ecs::engine<RegisteredComponents...>::entities::create_many(std::size_t count) {
+    std::vector<entity_id> created;
+    created.reserve(count);
+
+    // Reuse the freed ids first, then grow the entity bitset once for the remaining entities
+    while (created.size() < count && !_free_entities.empty()) {
+        created.push_back(_pop_free());
+    }
+    entity_id first = _entities.size();
+    _entities.resize(first + (count - created.size()));
+    for (entity_id entity = first; entity < _entities.size(); entity++) {
+        created.push_back(entity);
+    }
+
+    for (entity_id entity : created) {
+        _entities.set(entity);
+        _ecs._on_entity_created(entity);
+    }
+    return created;
+}
+
+template <typename... RegisteredComponents>
+bool neat::ecs::engine<RegisteredComponents...>::entities::remove(entity_id entity) {
+    if (!exists(entity))
+        return false;
+    std::apply([entity](auto&&... comp) { ((comp.remove(entity)), ...); },
+               _ecs.components._components);
+    _ecs._on_entity_removed(entity);
+    _entities.reset(entity);
+    _push_free(entity);
+    return true;
+}
+
+template <typename... RegisteredComponents>
+std::size_t neat::ecs::engine<RegisteredComponents...>::entities::remove_many(std::span<const entity_id> entity_list) {
+    std::vector<entity_id> removed;
+    removed.reserve(entity_list.size());
+    for (entity_id entity : entity_list) {
+        if (!exists(entity))
+            continue;
+        _entities.reset(entity);  // Reset immediately, so that duplicates are only removed once
+        removed.push_back(entity);
+    }
+
+    // Remove the components one component list at a time
+    std::apply([&removed](auto&&... comp) {
+        ([&] {
+            for (entity_id entity : removed) {
+                comp.remove(entity);
+            }
+        }(),
+         ...);
+    },
+               _ecs.components._components);
+    for (entity_id entity : removed) {
+        _ecs._on_entity_removed(entity);
+        _push_free(entity);
+    }
+    return removed.size();
+}
+
+template <typename... RegisteredComponents>
+bool neat::ecs::engine<RegisteredComponents...>::entities::exists(
+    entity_id entity) const {
+    if (entity >= _entities.size()) {
+        return false;
+    }
+    return _entities.test(entity);
+}
+
+template <typename... RegisteredComponents>
+neat::ecs::entity_id neat::ecs::engine<RegisteredComponents...>::entities::last() const {
+    entity_id last = _entities.find_last();
+    if (last >= _entities.size())
+        return 0;
+    return last;
+}
+
+template <typename... RegisteredComponents>
+std::vector<neat::ecs::entity_id> neat::ecs::engine<RegisteredComponents...>::entities::all() const {
+    std::vector<entity_id> found_entities;
+    found_entities.reserve(_entities.count());
+    for (entity_id entity = _entities.find_next(0); entity < _entities.size(); entity = _entities.find_next(entity + 1)) {
+        found_entities.push_back(entity);
+    }
+    return found_entities;
+}
+
+template <typename... RegisteredComponents>
+void neat::ecs::engine<RegisteredComponents...>::entities::set_reuse_policy(reuse_policy policy) {
+    if (policy == reuse_policy::lowest_first && _policy != reuse_policy::lowest_first)
+        for (std::size_t index = _free_entities.size() / 2; index-- > 0;) {
+            _sift_down(index);
+        }
+    _policy = policy;
+}
+
+template <typename... RegisteredComponents>
+neat::ecs::reuse_policy neat::ecs::engine<RegisteredComponents...>::entities::policy() const {
+    return _policy;
+}
+
+template <typename... RegisteredComponents>
+std::vector<neat::ecs::entity_id> neat::ecs::engine<RegisteredComponents...>::entities::compact() {
+    // Live entities keep their relative order, so every entity moves to an id that is free or already moved
+    std::vector<entity_id> remap(_entities.size(), invalid_entity);
+    std::size_t            count = 0;
+    for (entity_id entity = _entities.find_next(0); entity < _entities.size(); entity = _entities.find_next(entity + 1)) {
+        remap[entity] = count++;
+    }
+
+    std::apply([&remap, count](auto&... lists) { (lists.compact(remap, count), ...); }, _ecs.components._components);
+    _entities.resize(0);
+    _entities.resize(count);
+    for (entity_id entity = 0; entity < count; entity++) {
+        _entities.set(entity);
+    }
+    _free_entities.clear();
+    _free_entities.shrink_to_fit();
+
+    for (query_state* query : _ecs._queries) {
+        std::vector<entity_id> matched(query->entities.entities().begin(), query->entities.entities().end());
+        query->entities.clear();
+        for (entity_id entity : matched) {
+            query->entities.insert(remap[entity]);
+        }
+    }
+    return remap;
+}
+
+#pragma endregion ecs entities implementations
+
+#pragma region ecs components implementations
+
+template <typename... RegisteredComponents>
+neat::ecs::engine<RegisteredComponents...>::components::components(engine& e, std::pmr::memory_resource* resource)
+    : _ecs(e), _components(typing::repeat<RegisteredComponents>(resource)...) {};
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent>
+neat::ecs::typing::pointer_t<RequestedComponent> neat::ecs::engine<RegisteredComponents...>::components::get(entity_id entity) {
+    static_assert(typing::is_one_of<std::remove_const_t<RequestedComponent>, RegisteredComponents...>, "Requested component type is not registered.");
+    static_assert(!typing::is_singleton<RequestedComponent>, "Singleton components are not attached to entities.");
+    if (!_ecs.entities.exists(entity))
+        return nullptr;
+    typing::pointer_t<RequestedComponent> component = _ecs._get_components_list<RequestedComponent>().get(entity);
+    if (component != nullptr)
+        _ecs._mark_written<RequestedComponent>(entity);
+    return component;
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent>
+std::vector<neat::ecs::typing::pointer_t<RequestedComponent>> neat::ecs::engine<RegisteredComponents...>::components::get(const std::vector<entity_id>& entity_list) {
+    static_assert(typing::is_one_of<std::remove_const_t<RequestedComponent>, RegisteredComponents...>, "Requested component type is not registered.");
+    std::vector<typing::pointer_t<RequestedComponent>> result;
+    result.reserve(entity_list.size());
+    for (entity_id entity : entity_list) {
+        result.push_back(get<RequestedComponent>(entity));
+    }
+    return result;
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent, typename... Args>
+neat::ecs::typing::pointer_t<RequestedComponent> neat::ecs::engine<RegisteredComponents...>::components::add(entity_id entity, Args&&... args) {
+    static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
+    static_assert(!typing::is_singleton<RequestedComponent>, "Singleton components are not attached to entities.");
+    if (!_ecs.entities.exists(entity))
+        return nullptr;
+    typing::pointer_t<RequestedComponent> component = _ecs._get_components_list<RequestedComponent>().add(entity, std::forward<Args>(args)...);
+    _ecs._on_component_added<RequestedComponent>(entity);
+    return component;
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent, typename... Args>
+std::size_t neat::ecs::engine<RegisteredComponents...>::components::add_many(std::span<const entity_id> entity_list, const Args&... args) {
+    static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
+    static_assert(!typing::is_singleton<RequestedComponent>, "Singleton components are not attached to entities.");
+    auto& list = _ecs._get_components_list<RequestedComponent>();
+
+    // Grow the component list once for all entities
+    entity_id last = invalid_entity;
+    for (entity_id entity : entity_list) {
+        if (_ecs.entities.exists(entity))
+            last = last == invalid_entity ? entity : std::max(last, entity);
+    }
+    if (last != invalid_entity)
+        _ecs._grow_components<RequestedComponent>(last);
+
+    std::size_t added = 0;
+    for (entity_id entity : entity_list) {
+        if (!_ecs.entities.exists(entity))
+            continue;
+        list.add(entity, args...);
+        _ecs._on_component_added<RequestedComponent>(entity);
+        added++;
+    }
+    return added;
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent>
+bool neat::ecs::engine<RegisteredComponents...>::components::has(entity_id entity) const {
+    static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
+    static_assert(!typing::is_singleton<RequestedComponent>, "Singleton components are not attached to entities.");
+    if (!_ecs.entities.exists(entity))
+        return false;
+    return _ecs._get_components_list<RequestedComponent>().has(entity);
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent>
+bool neat::ecs::engine<RegisteredComponents...>::components::remove(entity_id entity) {
+    static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
+    static_assert(!typing::is_singleton<RequestedComponent>, "Singleton components are not attached to entities.");
+    if (!_ecs.entities.exists(entity))
+        return false;
+    if (!_ecs._get_components_list<RequestedComponent>().remove(entity))
+        return false;
+    _ecs._on_component_removed<RequestedComponent>(entity);
+    return true;
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent>
+std::tuple<neat::ecs::entity_id, neat::ecs::typing::pointer_t<RequestedComponent>> neat::ecs::engine<RegisteredComponents...>::components::first() {
+    static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
+    static_assert(!typing::is_singleton<RequestedComponent>, "Singleton components are not attached to entities.");
+    return _ecs._get_components_list<RequestedComponent>().first();
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent>
+typename neat::ecs::typing::fields_of<RequestedComponent>::spans neat::ecs::engine<RegisteredComponents...>::components::fields() {
+    static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
+    static_assert(typing::is_soa<RequestedComponent>, "Requested component type is not stored as struct-of-arrays.");
+    return _ecs._get_components_list<RequestedComponent>().fields();
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent>
+bool neat::ecs::engine<RegisteredComponents...>::components::allocate(size_t new_size) {
+    static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
+    return _ecs._get_components_list<RequestedComponent>().allocate(new_size);
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent, typename... Args>
+RequestedComponent* neat::ecs::engine<RegisteredComponents...>::components::set(Args&&... args) {
+    static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
+    static_assert(typing::is_singleton<RequestedComponent>, "Requested component type is not a singleton.");
+    return _ecs._get_components_list<RequestedComponent>().set(std::forward<Args>(args)...);
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent>
+RequestedComponent* neat::ecs::engine<RegisteredComponents...>::components::get() {
+    static_assert(typing::is_one_of<std::remove_const_t<RequestedComponent>, RegisteredComponents...>, "Requested component type is not registered.");
+    static_assert(typing::is_singleton<RequestedComponent>, "Requested component type is not a singleton.");
+    return _ecs._get_components_list<RequestedComponent>().get();
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent>
+bool neat::ecs::engine<RegisteredComponents...>::components::remove() {
+    static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
+    static_assert(typing::is_singleton<RequestedComponent>, "Requested component type is not a singleton.");
+    return _ecs._get_components_list<RequestedComponent>().reset();
+}
+
+template <typename... RegisteredComponents>
+bool neat::ecs::engine<RegisteredComponents...>::components::allocate_all(size_t new_size) {
+    bool allocated = false;
+    std::apply([new_size, &allocated](auto&&... comp) { ((allocated = allocated || comp.allocate(new_size)), ...); }, _ecs.components._components);
+    return allocated;
+}
+
+#pragma endregion ecs component implementations
+
+#pragma region ecs command buffer implementations
+
+template <typename... RegisteredComponents>
+neat::ecs::engine<RegisteredComponents...>::command_buffer::command_buffer() {}
+
+template <typename... RegisteredComponents>
+neat::ecs::engine<RegisteredComponents...>::command_buffer::~command_buffer() {}
+
+template <typename... RegisteredComponents>
+neat::ecs::entity_id neat::ecs::engine<RegisteredComponents...>::command_buffer::create() {
+    // The real id is only known when flushing, until then the entity is referred to by a provisional id
+    return provisional | _created++;
+}
+
+template <typename... RegisteredComponents>
+void neat::ecs::engine<RegisteredComponents...>::command_buffer::remove(entity_id entity) {
+    _removed.push_back(entity);
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent, typename... Args>
+void neat::ecs::engine<RegisteredComponents...>::command_buffer::add(entity_id entity, Args&&... args) {
+    static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
+    static_assert(std::is_constructible_v<RequestedComponent, Args...>, "Component type can't be built from given arguments.");
+    static_assert(!typing::is_singleton<RequestedComponent>, "Singleton components are not attached to entities.");
+    std::get<typing::get_index<RequestedComponent, RegisteredComponents...>()>(_commands).push_back({entity, std::optional<RequestedComponent>(std::in_place, std::forward<Args>(args)...)});
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent>
+void neat::ecs::engine<RegisteredComponents...>::command_buffer::remove(entity_id entity) {
+    static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
+    std::get<typing::get_index<RequestedComponent, RegisteredComponents...>()>(_commands).push_back({entity, std::nullopt});
+}
+
+template <typename... RegisteredComponents>
+void neat::ecs::engine<RegisteredComponents...>::command_buffer::merge(command_buffer&& other) {
+    // Provisional ids of the other buffer are shifted past the entities created by this buffer
+    std::size_t offset = _created;
+    auto        rebase = [offset](entity_id entity) { return (entity & provisional) ? entity + offset : entity; };
+
+    for (entity_id entity : other._removed) {
+        _removed.push_back(rebase(entity));
+    }
+    [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+        ([&] {
+            auto& commands = std::get<Indices>(_commands);
+            for (auto& command : std::get<Indices>(other._commands)) {
+                commands.push_back({rebase(command.entity), std::move(command.component)});
+            }
+        }(),
+         ...);
+    }(std::index_sequence_for<RegisteredComponents...> {});
+    _created += other._created;
+    other.clear();
+}
+
+template <typename... RegisteredComponents>
+void neat::ecs::engine<RegisteredComponents...>::command_buffer::clear() {
+    _created = 0;
+    _removed.clear();
+    std::apply([](auto&... commands) { (commands.clear(), ...); }, _commands);
+}
+
+template <typename... RegisteredComponents>
+bool neat::ecs::engine<RegisteredComponents...>::command_buffer::empty() const {
+    bool no_commands = std::apply([](const auto&... commands) { return (commands.empty() && ...); }, _commands);
+    return _created == 0 && _removed.empty() && no_commands;
+}
+
+template <typename... RegisteredComponents>
+neat::ecs::entity_id neat::ecs::engine<RegisteredComponents...>::command_buffer::_resolve(entity_id entity, const std::vector<entity_id>& created) {
+    // Provisional ids of other buffers, or of earlier flushes, don't refer to any created entity
+    if (entity & provisional) {
+        std::size_t index = entity & ~provisional;
+        return index < created.size() ? created[index] : invalid_entity;
+    }
+    return entity;
+}
+
+template <typename... RegisteredComponents>
+void neat::ecs::engine<RegisteredComponents...>::flush(command_buffer& buffer) {
+    // Create the entities first, so that the provisional ids can be resolved
+    std::vector<entity_id> created = entities.create_many(buffer._created);
+
+    // Apply the component commands per component type, then remove the entities
+    ([&] {
+        if constexpr (!typing::is_singleton<RegisteredComponents>)
+            _flush_commands<RegisteredComponents>(buffer, created);
+    }(),
+     ...);
+    for (entity_id entity : buffer._removed) {
+        entities.remove(command_buffer::_resolve(entity, created));
+    }
+    buffer.clear();
+}
+
+template <typename... RegisteredComponents>
+template <typename RequestedComponent>
+void neat::ecs::engine<RegisteredComponents...>::_flush_commands(command_buffer& buffer, const std::vector<entity_id>& created) {
+    auto& commands = std::get<typing::get_index<RequestedComponent, RegisteredComponents...>()>(buffer._commands);
+    if (commands.empty())
+        return;
+
+    // Grow the component list once for all added components
+    entity_id last = invalid_entity;
+    for (const auto& command : commands) {
+        entity_id entity = command_buffer::_resolve(command.entity, created);
+        if (command.component && entity != invalid_entity)
+            last = last == invalid_entity ? entity : std::max(last, entity);
+    }
+    if (last != invalid_entity)
+        _grow_components<RequestedComponent>(last);
+
+    for (auto& command : commands) {
+        entity_id entity = command_buffer::_resolve(command.entity, created);
+        if (entity == invalid_entity)
+            continue;
+        if (command.component)
+            components.template add<RequestedComponent>(entity, std::move(*command.component));
+        else
+            components.template remove<RequestedComponent>(entity);
+    }
+}
+
+#pragma endregion ecs command buffer implementations
+
+#pragma region ecs system implementations
+
+template <typename... RegisteredComponents>
+neat::ecs::engine<RegisteredComponents...>::systems::systems(engine& e)
+    : _ecs(e) {};
+
+template <typename... RegisteredComponents>
+template <typename... FuncComponents>
+void neat::ecs::engine<RegisteredComponents...>::systems::execute(void (&system)(entity_id, FuncComponents*...)) {
+    _execute<true, FuncComponents...>(active_profiler::identify(system), [&system](auto data) { std::apply(system, data); });
+}
+
+template <typename... RegisteredComponents>
+template <typename... FuncComponents>
+void neat::ecs::engine<RegisteredComponents...>::systems::execute(void (&system)(FuncComponents*...)) {
+    _execute<false, FuncComponents...>(active_profiler::identify(system), [&system](auto data) { std::apply(system, data); });
+}
+
+template <typename... RegisteredComponents>
+template <typename... FuncComponents>
+void neat::ecs::engine<RegisteredComponents...>::systems::execute(void (&system)(engine<RegisteredComponents...>&, entity_id, FuncComponents*...)) {
+    _execute<true, FuncComponents...>(active_profiler::identify(system), [this, &system](auto data) { std::apply(system, std::tuple_cat(std::tie(this->_ecs), data)); });
+}
+
+template <typename... RegisteredComponents>
+template <typename... FuncComponents>
+void neat::ecs::engine<RegisteredComponents...>::systems::execute(void (&system)(engine<RegisteredComponents...>&, FuncComponents*...)) {
+    _execute<false, FuncComponents...>(active_profiler::identify(system), [this, &system](auto data) { std::apply(system, std::tuple_cat(std::tie(this->_ecs), data)); });
+}
+
+template <typename... RegisteredComponents>
+template <typename... FuncComponents>
+void neat::ecs::engine<RegisteredComponents...>::systems::execute_parallel(thread_pool& pool, void (&system)(FuncComponents*...), std::size_t grain_size) {
+    _execute_parallel<false, FuncComponents...>(active_profiler::identify(system), pool, grain_size, [&system](auto data) { std::apply(system, data); });
+}
+
+template <typename... RegisteredComponents>
+template <typename... FuncComponents>
+void neat::ecs::engine<RegisteredComponents...>::systems::execute_parallel(thread_pool& pool, void (&system)(entity_id, FuncComponents*...), std::size_t grain_size) {
+    _execute_parallel<true, FuncComponents...>(active_profiler::identify(system), pool, grain_size, [&system](auto data) { std::apply(system, data); });
+}
+
+template <typename... RegisteredComponents>
+template <typename... FuncComponents>
+void neat::ecs::engine<RegisteredComponents...>::systems::execute_parallel(thread_pool& pool, void (&system)(engine<RegisteredComponents...>&, FuncComponents*...), std::size_t grain_size) {
+    _execute_parallel<false, FuncComponents...>(active_profiler::identify(system), pool, grain_size, [this, &system](auto data) { std::apply(system, std::tuple_cat(std::tie(this->_ecs), data)); });
+}
+
+template <typename... RegisteredComponents>
+template <typename... FuncComponents>
+void neat::ecs::engine<RegisteredComponents...>::systems::execute_parallel(thread_pool& pool, void (&system)(engine<RegisteredComponents...>&, entity_id, FuncComponents*...), std::size_t grain_size) {
+    _execute_parallel<true, FuncComponents...>(active_profiler::identify(system), pool, grain_size, [this, &system](auto data) { std::apply(system, std::tuple_cat(std::tie(this->_ecs), data)); });
+}
+
+template <typename... RegisteredComponents>
+template <typename System>
+    requires neat::ecs::typing::system_object<neat::ecs::engine<RegisteredComponents...>, System>
+void neat::ecs::engine<RegisteredComponents...>::systems::execute(System&& system) {
+    using signature = typing::system_signature<engine, typename typing::callable_traits<std::remove_cvref_t<System>>::arguments>;
+    typing::unpack<typename signature::components>::apply([this, &system]<typename... FuncComponents>() {
+        _execute<signature::with_entity, FuncComponents...>(active_profiler::identify(system), [this, &system](auto data) {
+            if constexpr (signature::with_engine)
+                std::apply(system, std::tuple_cat(std::tie(this->_ecs), data));
+            else
+                std::apply(system, data);
+        });
+    });
+}
+
+template <typename... RegisteredComponents>
+template <typename System>
+    requires neat::ecs::typing::system_object<neat::ecs::engine<RegisteredComponents...>, System>
+void neat::ecs::engine<RegisteredComponents...>::systems::execute_parallel(thread_pool& pool, System&& system, std::size_t grain_size) {
+    using signature = typing::system_signature<engine, typename typing::callable_traits<std::remove_cvref_t<System>>::arguments>;
+    typing::unpack<typename signature::components>::apply([this, &pool, &system, grain_size]<typename... FuncComponents>() {
+        _execute_parallel<signature::with_entity, FuncComponents...>(active_profiler::identify(system), pool, grain_size, [this, &system](auto data) {
+            if constexpr (signature::with_engine)
+                std::apply(system, std::tuple_cat(std::tie(this->_ecs), data));
+            else
+                std::apply(system, data);
+        });
+    });
+}
+
+template <typename... RegisteredComponents>
+template <typename System>
+void neat::ecs::engine<RegisteredComponents...>::systems::name(const System& system, std::string name) {
+    _ecs._profiler.name(active_profiler::identify(system), std::move(name));
+}
+
+template <typename... RegisteredComponents>
+template <bool WithEntity, typename... FuncComponents, typename System>
+void neat::ecs::engine<RegisteredComponents...>::systems::_execute(const active_profiler::system_id& id, System&& system) {
+    active_profiler::scope                scope(_ecs._profiler, id);
+    view<engine, true, FuncComponents...> all(_ecs);
+    for (auto it = scope.query([&all] { return all.begin(); }); it != all.end(); scope.query([&it] { ++it; })) {
+        _invoke<WithEntity, FuncComponents...>(system, *it);
+        scope.visit();
+    }
+}
+
+template <typename... RegisteredComponents>
+template <bool WithEntity, typename... FuncComponents, typename System>
+void neat::ecs::engine<RegisteredComponents...>::systems::_execute_parallel(const active_profiler::system_id& id, thread_pool& pool, std::size_t grain_size, System&& system) {
+    // Split the range of the query into chunks, every chunk walks its own slice of the query
+    active_profiler::scope                scope(_ecs._profiler, id);
+    view<engine, true, FuncComponents...> all(_ecs);
+    pool.parallel_for(0, all._cursor_end(), grain_size, [this, &id, &system](std::size_t first, std::size_t last) {
+        active_profiler::scope                chunk(_ecs._profiler, id, false);
+        view<engine, true, FuncComponents...> part(_ecs, first, last);
+        for (auto it = chunk.query([&part] { return part.begin(); }); it != part.end(); chunk.query([&it] { ++it; })) {
+            _invoke<WithEntity, FuncComponents...>(system, *it);
+            chunk.visit();
+        }
+    });
+}
+
+template <typename... RegisteredComponents>
+template <bool WithEntity, typename... FuncComponents, typename System>
+void neat::ecs::engine<RegisteredComponents...>::systems::_invoke(System& system, const std::tuple<entity_id, FuncComponents*...>& data) {
+    // Writable components are marked as changed, even if the system does not actually modify them
+    _ecs._mark_written<FuncComponents...>(std::get<0>(data));
+    if constexpr (WithEntity)
+        system(data);
+    else
+        system(std::apply([](entity_id, FuncComponents*... components) { return std::tuple<FuncComponents*...>(components...); }, data));
+}
+
+template <typename... RegisteredComponents>
+template <typename... FuncComponents>
+void neat::ecs::engine<RegisteredComponents...>::systems::execute_batched(void (&system)(std::span<const entity_id>, std::span<FuncComponents>...), std::size_t batch_size) {
+    active_profiler::scope scope(_ecs._profiler, active_profiler::identify(system));
+    _execute_batched<FuncComponents...>(scope, 0, _ecs._entity_capacity(), batch_size, system);
+}
 
-template <typename T, typename... Ts>
-inline constexpr auto are_all_classes<T, Ts...> = std::bool_constant<(std::is_class_v<T>)&&are_all_classes<Ts...>> {};
+template <typename... RegisteredComponents>
+template <typename... FuncComponents>
+void neat::ecs::engine<RegisteredComponents...>::systems::execute_batched_parallel(thread_pool& pool, void (&system)(std::span<const entity_id>, std::span<FuncComponents>...), std::size_t grain_size) {
+    // Batches never cross the boundaries of the chunks, so every chunk can be walked independently
+    active_profiler::scope scope(_ecs._profiler, active_profiler::identify(system));
+    pool.parallel_for(0, _ecs._entity_capacity(), grain_size, [this, &system, grain_size](std::size_t first, std::size_t last) {
+        active_profiler::scope chunk(_ecs._profiler, active_profiler::identify(system), false);
+        _execute_batched<FuncComponents...>(chunk, first, last, grain_size, system);
+    });
+}
 
-template <typename Subset, typename Set> constexpr bool is_subset_of = false;
-template <typename... Ts, typename... Us>
-inline constexpr bool is_subset_of<std::tuple<Ts...>, std::tuple<Us...>> = (is_one_of<Ts, Us...> && ...);
+template <typename... RegisteredComponents>
+template <typename... FuncComponents, typename System>
+void neat::ecs::engine<RegisteredComponents...>::systems::_execute_batched(active_profiler::scope& scope, entity_id first, entity_id last, std::size_t batch_size, System& system) {
+    static_assert(sizeof...(FuncComponents) > 0, "Batched systems require at least one component type.");
+    static_assert(!(typing::is_soa<FuncComponents> || ...), "Struct-of-arrays components can not be received by systems, use components.fields instead.");
+    static_assert(!((typing::is_tag<FuncComponents> || typing::is_singleton<FuncComponents>) || ...), "Tag and singleton components can not be received by batched systems, as they are not stored in an array.");
+    batch_size = std::max<std::size_t>(batch_size, 1);
 
-}  // namespace typing
+    std::vector<entity_id> entity_ids(batch_size);
+    // When no entity is found, the end of the shortest component list is returned, which never has all components
+    entity_id              entity = scope.query([this, first] { return _ecs._find_next_entity_with_components<FuncComponents...>(first); });
+    while (entity < last && _ecs._entity_has_components<FuncComponents...>(entity)) {
+        // Extend the batch as long as the components of the next entity directly follow those of the previous one
+        std::tuple<FuncComponents*...> components(_ecs._get_components_list<FuncComponents>().get(entity)...);
+        std::size_t                    count = 1;
+        while (count < batch_size && entity + count < last && ((_ecs._get_components_list<FuncComponents>().get(entity + count) == std::get<FuncComponents*>(components) + count) && ...)) {
+            count++;
+        }
 
-using entity_id                = std::size_t;
-const entity_id invalid_entity = SIZE_MAX;
+        for (std::size_t index = 0; index < count; index++) {
+            entity_ids[index] = entity + index;
+            _ecs._mark_written<FuncComponents...>(entity + index);
+        }
+        system(std::span<const entity_id>(entity_ids.data(), count), std::span<FuncComponents>(std::get<FuncComponents*>(components), count)...);
+        scope.visit(count);
+        entity = scope.query([this, next = entity + count] { return _ecs._find_next_entity_with_components<FuncComponents...>(next); });
+    }
+}
 
-template <typename ComponentType>
-class componentlist {
-   private:
-    std::vector<bool>          _tags;
-    std::vector<ComponentType> _components;
+#pragma endregion ecs systems implementations
 
-   public:
-    componentlist();
-    ~componentlist();
+#pragma region ecs scheduler implementations
 
-    template <typename... Args>
-    ComponentType* add(entity_id entity, Args... args);
-    ComponentType* get(entity_id entity);
+template <typename... RegisteredComponents>
+neat::ecs::engine<RegisteredComponents...>::scheduler::scheduler(engine& e)
+    : _ecs(e) {};
 
-    bool has(entity_id entity) const;
-    bool remove(entity_id entity);
-    bool allocate(size_t new_count);
+template <typename... RegisteredComponents>
+template <typename... FuncComponents>
+std::size_t neat::ecs::engine<RegisteredComponents...>::scheduler::add(void (&system)(FuncComponents*...)) {
+    return _add<false, FuncComponents...>([this, &system] { _ecs.systems.execute(system); });
+}
 
-    std::tuple<entity_id, ComponentType*> first();
-};
+template <typename... RegisteredComponents>
+template <typename... FuncComponents>
+std::size_t neat::ecs::engine<RegisteredComponents...>::scheduler::add(void (&system)(entity_id, FuncComponents*...)) {
+    return _add<false, FuncComponents...>([this, &system] { _ecs.systems.execute(system); });
+}
 
 template <typename... RegisteredComponents>
-class engine {
-   private:
-    class entities;
-    class components;
-    class systems;
+template <typename... FuncComponents>
+std::size_t neat::ecs::engine<RegisteredComponents...>::scheduler::add(void (&system)(engine<RegisteredComponents...>&, FuncComponents*...)) {
+    return _add<true, FuncComponents...>([this, &system] { _ecs.systems.execute(system); });
+}
 
-   public:
-    engine();
-    ~engine();
+template <typename... RegisteredComponents>
+template <typename... FuncComponents>
+std::size_t neat::ecs::engine<RegisteredComponents...>::scheduler::add(void (&system)(engine<RegisteredComponents...>&, entity_id, FuncComponents*...)) {
+    return _add<true, FuncComponents...>([this, &system] { _ecs.systems.execute(system); });
+}
 
-    template <typename... RequestedComponents> std::vector<std::tuple<entity_id, RequestedComponents*...>> iterate();
-    template <typename... RequestedComponents> std::vector<std::tuple<RequestedComponents*...>>            iterate_components();
+template <typename... RegisteredComponents>
+template <typename System>
+    requires neat::ecs::typing::system_object<neat::ecs::engine<RegisteredComponents...>, System>
+std::size_t neat::ecs::engine<RegisteredComponents...>::scheduler::add(System&& system) {
+    // The scheduler keeps its own copy of the function object, as it runs after this call returns
+    using signature = typing::system_signature<engine, typename typing::callable_traits<std::remove_cvref_t<System>>::arguments>;
+    return typing::unpack<typename signature::components>::apply([this, &system]<typename... FuncComponents>() {
+        return _add<signature::with_engine, FuncComponents...>([this, system = std::forward<System>(system)]() mutable { _ecs.systems.execute(system); });
+    });
+}
 
-    entities   entities;
-    components components;
-    systems    systems;
+template <typename... RegisteredComponents>
+template <bool Exclusive, typename... FuncComponents>
+std::size_t neat::ecs::engine<RegisteredComponents...>::scheduler::_add(std::function<void()> run) {
+    static_assert(typing::is_subset_of<std::tuple<std::remove_const_t<FuncComponents>...>, std::tuple<RegisteredComponents...>>, "At least one of the requested components is not registered.");
 
-   private:
-    template <typename RequestedComponent> componentlist<RequestedComponent>&                 _get_components_list();
-    template <typename... RequestedComponents> std::vector<entity_id>                         _get_entities_who_have_components();
-    template <typename... RequestedComponents> std::tuple<entity_id, RequestedComponents*...> _get_entity_components_with_entity(entity_id entity);
-    template <typename... RequestedComponents> std::tuple<RequestedComponents*...>            _get_entity_components_without_entity(entity_id entity);
+    // Components received as pointer to const are only read, others are written
+    scheduled_system system {std::move(run), {}, {}, Exclusive};
+    ([&system] {
+        constexpr std::size_t index = typing::get_index<std::remove_const_t<FuncComponents>, RegisteredComponents...>();
+        if constexpr (std::is_const_v<FuncComponents>)
+            system.reads.set(index);
+        else
+            system.writes.set(index);
+    }(),
+     ...);
 
-   private:
-    class entities final {
-       private:
-        friend class engine;
-        engine&               _ecs;
-        std::vector<bool>     _entities;
-        std::queue<entity_id> _free_entities;
-        explicit entities(engine& e);
+    _systems.push_back(std::move(system));
+    _dirty = true;
+    return _systems.size() - 1;
+}
 
-       public:
-        entity_id              create();
-        bool                   remove(entity_id entity);
-        bool                   exists(entity_id entity) const;
-        entity_id              last() const;
-        std::vector<entity_id> all() const;
-    };
+template <typename... RegisteredComponents>
+bool neat::ecs::engine<RegisteredComponents...>::scheduler::_conflicts(const scheduled_system& first, const scheduled_system& second) const {
+    if (first.exclusive || second.exclusive)
+        return true;
+    return (first.writes & (second.reads | second.writes)).any() || (second.writes & first.reads).any();
+}
 
-    class components final {
-       private:
-        friend class engine;
-        engine&                                            _ecs;
-        std::tuple<componentlist<RegisteredComponents>...> _components;
-        explicit components(engine& e);
+template <typename... RegisteredComponents>
+const std::vector<std::vector<std::size_t>>& neat::ecs::engine<RegisteredComponents...>::scheduler::schedule() {
+    if (!_dirty)
+        return _stages;
 
-       public:
-        template <typename RequestedComponent> RequestedComponent*                   get(entity_id entity);
-        template <typename RequestedComponent> std::vector<RequestedComponent*>      get(const std::vector<entity_id>& entity_list);
-        template <typename RequestedComponent, typename... Args> RequestedComponent* add(entity_id entity, Args... args);
+    // Every system runs in the stage after the last earlier registered system it conflicts with
+    std::vector<std::size_t> stage_of(_systems.size(), 0);
+    _stages.clear();
+    for (std::size_t system = 0; system < _systems.size(); system++) {
+        for (std::size_t earlier = 0; earlier < system; earlier++) {
+            if (_conflicts(_systems[earlier], _systems[system]))
+                stage_of[system] = std::max(stage_of[system], stage_of[earlier] + 1);
+        }
+        if (stage_of[system] >= _stages.size())
+            _stages.resize(stage_of[system] + 1);
+        _stages[stage_of[system]].push_back(system);
+    }
 
-        template <typename RequestedComponent> bool has(entity_id entity) const;
-        template <typename RequestedComponent> bool remove(entity_id entity);
-        template <typename RequestedComponent> bool allocate(size_t new_size);
-        bool                                        allocate_all(size_t new_size);
+    _dirty = false;
+    return _stages;
+}
 
-        template <typename RequestedComponent> std::tuple<entity_id, RequestedComponent*> first();
-    };
+template <typename... RegisteredComponents>
+void neat::ecs::engine<RegisteredComponents...>::scheduler::run(thread_pool& pool) {
+    for (const std::vector<std::size_t>& stage : schedule()) {
+        if (stage.size() == 1) {
+            _systems[stage[0]].run();
+            continue;
+        }
+        pool.parallel_for(0, stage.size(), 1, [this, &stage](std::size_t first, std::size_t last) {
+            for (std::size_t index = first; index < last; index++) {
+                _systems[stage[index]].run();
+            }
+        });
+    }
+}
 
-    class systems final {
-       private:
-        friend class engine;
-        engine& _ecs;
-        explicit systems(engine& e);
+template <typename... RegisteredComponents>
+std::size_t neat::ecs::engine<RegisteredComponents...>::scheduler::size() const {
+    return _systems.size();
+}
 
-       public:
-        template <typename... FuncComponents> void execute(void (&system)(FuncComponents*...));
-        template <typename... FuncComponents> void execute(void (&system)(entity_id, FuncComponents*...));
-        template <typename... FuncComponents> void execute(void (&system)(engine<RegisteredComponents...>&, FuncComponents*...));
-        template <typename... FuncComponents> void execute(void (&system)(engine<RegisteredComponents...>&, entity_id, FuncComponents*...));
-    };
-};
-};  // namespace neat::ecs
+#pragma endregion ecs scheduler implementations
 
-#pragma region componentlist implementations
+#pragma region archetype view implementations
 
-template <typename ComponentType>
-neat::ecs::componentlist<ComponentType>::componentlist() {
-    static_assert(std::is_class_v<ComponentType>, "Component type is not a struct or class.");
-    static_assert(std::is_default_constructible_v<ComponentType>, "Component type does not have a default constructor.");
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+neat::ecs::archetype_view<Engine, WithEntity, RequestedComponents...>::archetype_view(Engine& ecs)
+    : _ecs(&ecs) {}
+
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+typename neat::ecs::archetype_view<Engine, WithEntity, RequestedComponents...>::iterator neat::ecs::archetype_view<Engine, WithEntity, RequestedComponents...>::begin() const {
+    return iterator(_ecs, 0);
 }
 
-template <typename ComponentType>
-neat::ecs::componentlist<ComponentType>::componentlist::~componentlist() {}
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+typename neat::ecs::archetype_view<Engine, WithEntity, RequestedComponents...>::iterator neat::ecs::archetype_view<Engine, WithEntity, RequestedComponents...>::end() const {
+    return iterator(_ecs, _ecs->_archetypes.size());
+}
 
-template <typename ComponentType>
-bool neat::ecs::componentlist<ComponentType>::componentlist::has(
-    entity_id entity) const {
-    if (entity >= _tags.size())
-        return false;
-    return _tags[entity];
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+neat::ecs::archetype_view<Engine, WithEntity, RequestedComponents...>::iterator::iterator(Engine* ecs, std::size_t archetype)
+    : _ecs(ecs), _archetype(archetype) {
+    _skip_to_match();
 }
 
-template <typename ComponentType>
-ComponentType* neat::ecs::componentlist<ComponentType>::componentlist::get(entity_id entity) {
-    if (!has(entity))
-        return nullptr;
-    return &_components[entity];
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+typename neat::ecs::archetype_view<Engine, WithEntity, RequestedComponents...>::iterator::value_type neat::ecs::archetype_view<Engine, WithEntity, RequestedComponents...>::iterator::operator*() const {
+    return typing::unpack<typename query::returned>::apply([this]<typename... Returned>() -> value_type {
+        if constexpr (WithEntity)
+            return {reinterpret_cast<entity_id*>(_ecs->_archetypes[_archetype].chunks[_chunk])[_index], _get_component<std::remove_pointer_t<Returned>>()...};
+        else
+            return {_get_component<std::remove_pointer_t<Returned>>()...};
+    });
 }
 
-template <typename ComponentType>
-template <typename... Args>
-ComponentType* neat::ecs::componentlist<ComponentType>::componentlist::add(neat::ecs::entity_id entity, Args... args) {
-    static_assert(std::is_constructible_v<ComponentType, Args...>, "Component type can't be built from given arguments.");
-    if (entity >= _tags.size()) {
-        _tags.resize(entity + 1, false);
-        _components.resize(entity + 1);
-    }
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+typename neat::ecs::archetype_view<Engine, WithEntity, RequestedComponents...>::iterator& neat::ecs::archetype_view<Engine, WithEntity, RequestedComponents...>::iterator::operator++() {
+    _index++;
+    _skip_to_match();
+    return *this;
+}
 
-    _tags[entity]       = true;
-    _components[entity] = ComponentType(args...);
-    return &_components[entity];
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+typename neat::ecs::archetype_view<Engine, WithEntity, RequestedComponents...>::iterator neat::ecs::archetype_view<Engine, WithEntity, RequestedComponents...>::iterator::operator++(int) {
+    iterator previous = *this;
+    ++*this;
+    return previous;
 }
 
-template <typename ComponentType>
-bool neat::ecs::componentlist<ComponentType>::componentlist::remove(entity_id entity) {
-    if (!has(entity))
-        return false;
-    _tags[entity]       = false;
-    _components[entity] = ComponentType();  // Replace with a default component
-    return true;
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+bool neat::ecs::archetype_view<Engine, WithEntity, RequestedComponents...>::iterator::operator==(const iterator& other) const {
+    return _archetype == other._archetype && _chunk == other._chunk && _index == other._index;
 }
 
-template <typename ComponentType>
-std::tuple<neat::ecs::entity_id, ComponentType*> neat::ecs::componentlist<ComponentType>::componentlist::first() {
-    for (entity_id entity = 0; entity < _tags.size(); entity++) {
-        if (_tags[entity]) {
-            return {entity, &_components[entity]};
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+void neat::ecs::archetype_view<Engine, WithEntity, RequestedComponents...>::iterator::_skip_to_match() {
+    constexpr std::uint64_t mask = typing::unpack<typename query::required>::apply([]<typename... Required>() {
+        return (std::uint64_t(0) | ... | Engine::template _mask_of<Required>());
+    });
+    constexpr std::uint64_t excluded = typing::unpack<typename query::excluded>::apply([]<typename... Excluded>() {
+        return (std::uint64_t(0) | ... | Engine::template _mask_of<Excluded>());
+    });
+    while (_archetype < _ecs->_archetypes.size()) {
+        const auto& archetype = _ecs->_archetypes[_archetype];
+        if ((archetype.mask & mask) == mask && (archetype.mask & excluded) == 0) {
+            if (_index == archetype.capacity) {
+                _chunk++;
+                _index = 0;
+            }
+            if (_chunk * archetype.capacity + _index < archetype.count)
+                return;
         }
+        _archetype++;
+        _chunk = 0;
+        _index = 0;
     }
-    return {invalid_entity, nullptr};
 }
 
-template <typename ComponentType>
-bool neat::ecs::componentlist<ComponentType>::componentlist::allocate(
-    size_t new_count) {
-    if (new_count < _tags.size()) {
-        return false;
-    }
-    _tags.resize(new_count, false);
-    _components.resize(new_count);
-    return true;
+template <typename Engine, bool WithEntity, typename... RequestedComponents>
+template <typename RequestedComponent>
+RequestedComponent* neat::ecs::archetype_view<Engine, WithEntity, RequestedComponents...>::iterator::_get_component() const {
+    const auto& archetype = _ecs->_archetypes[_archetype];
+    if (!(archetype.mask & Engine::template _mask_of<RequestedComponent>()))
+        return nullptr;  // Optional component which is not part of the archetype
+    std::byte* chunk = archetype.chunks[_chunk];
+    return reinterpret_cast<RequestedComponent*>(chunk + archetype.offsets[Engine::template _index_of<RequestedComponent>()]) + _index;
 }
 
-#pragma endregion componentlist implementations
+#pragma endregion archetype view implementations
 
-#pragma region ecs implementations
+#pragma region archetype engine implementations
 
 template <typename... RegisteredComponents>
-neat::ecs::engine<RegisteredComponents...>::engine()
+neat::ecs::archetype_engine<RegisteredComponents...>::archetype_engine()
     : entities(*this), components(*this), systems(*this) {
     static_assert(typing::are_unique_types<RegisteredComponents...>, "Not all registered component types are unique.");
     static_assert(typing::are_all_classes<RegisteredComponents...>, "All registered component types must be a struct or a class.");
+    static_assert(sizeof...(RegisteredComponents) <= 64, "At most 64 component types can be registered.");
+    static_assert((std::is_move_constructible_v<RegisteredComponents> && ...), "All registered component types must be move constructible.");
+    static_assert(!(typing::is_soa<RegisteredComponents> || ...), "Struct-of-arrays storage is not supported by the archetype engine.");
+    static_assert(!(typing::is_singleton<RegisteredComponents> || ...), "Singleton storage is not supported by the archetype engine.");
+    _get_archetype(0);  // Archetype for entities without components
 }
 
 template <typename... RegisteredComponents>
-neat::ecs::engine<RegisteredComponents...>::engine::~engine() {}
+neat::ecs::archetype_engine<RegisteredComponents...>::~archetype_engine() {
+    for (archetype_type& archetype : _archetypes) {
+        for (std::size_t row = 0; row < archetype.count; row++) {
+            for (std::size_t column = 0; column < _columns.size(); column++) {
+                if (archetype.mask & (std::uint64_t(1) << column))
+                    _columns[column].destroy(_column_at(archetype, column, row));
+            }
+        }
+        for (std::byte* chunk : archetype.chunks) {
+            ::operator delete(chunk, std::align_val_t(archetype.alignment));
+        }
+    }
+}
 
 template <typename... RegisteredComponents>
 template <typename... RequestedComponents>
-std::vector<std::tuple<neat::ecs::entity_id, RequestedComponents*...>> neat::ecs::engine<RegisteredComponents...>::iterate() {
-    static_assert(typing::is_subset_of<std::tuple<RequestedComponents...>, std::tuple<RegisteredComponents...>>, "At least one of the requested components is not registered.");
-
-    std::vector<entity_id> valid_entities = _get_entities_who_have_components<RequestedComponents...>();
-
-    std::vector<std::tuple<entity_id, RequestedComponents*...>> results;
-    results.reserve(valid_entities.size());
-
-    for (entity_id entity : valid_entities) {
-        results.push_back(_get_entity_components_with_entity<RequestedComponents...>(entity));
-    }
-    return results;
+neat::ecs::archetype_view<neat::ecs::archetype_engine<RegisteredComponents...>, true, RequestedComponents...> neat::ecs::archetype_engine<RegisteredComponents...>::iterate() {
+    static_assert(typing::query<RequestedComponents...>::template is_registered<RegisteredComponents...>, "At least one of the requested components is not registered.");
+    static_assert(!typing::query<RequestedComponents...>::has_ticks, "Change detection is not supported by the archetype engine.");
+    return archetype_view<archetype_engine, true, RequestedComponents...>(*this);
 }
 
 template <typename... RegisteredComponents>
 template <typename... RequestedComponents>
-std::vector<std::tuple<RequestedComponents*...>> neat::ecs::engine<RegisteredComponents...>::iterate_components() {
-    static_assert(typing::is_subset_of<std::tuple<RequestedComponents...>, std::tuple<RegisteredComponents...>>, "At least one of the requested components is not registered.");
+neat::ecs::archetype_view<neat::ecs::archetype_engine<RegisteredComponents...>, false, RequestedComponents...> neat::ecs::archetype_engine<RegisteredComponents...>::iterate_components() {
+    static_assert(typing::query<RequestedComponents...>::template is_registered<RegisteredComponents...>, "At least one of the requested components is not registered.");
+    static_assert(!typing::query<RequestedComponents...>::has_ticks, "Change detection is not supported by the archetype engine.");
+    return archetype_view<archetype_engine, false, RequestedComponents...>(*this);
+}
 
-    std::vector<entity_id>                           valid_entities = _get_entities_who_have_components<RequestedComponents...>();
-    std::vector<std::tuple<RequestedComponents*...>> results;
+template <typename... RegisteredComponents>
+std::size_t neat::ecs::archetype_engine<RegisteredComponents...>::archetype_count() const {
+    return _archetypes.size();
+}
 
-    results.reserve(valid_entities.size());
+template <typename... RegisteredComponents>
+template <typename RequestedComponent>
+constexpr std::size_t neat::ecs::archetype_engine<RegisteredComponents...>::_index_of() {
+    static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
+    return typing::get_index<RequestedComponent, RegisteredComponents...>();
+}
 
-    for (entity_id entity : valid_entities) {
-        results.push_back(_get_entity_components_without_entity<RequestedComponents...>(entity));
-    }
-    return results;
+template <typename... RegisteredComponents>
+template <typename RequestedComponent>
+constexpr std::uint64_t neat::ecs::archetype_engine<RegisteredComponents...>::_mask_of() {
+    return std::uint64_t(1) << _index_of<RequestedComponent>();
 }
 
 template <typename... RegisteredComponents>
 template <typename RequestedComponent>
-neat::ecs::componentlist<RequestedComponent>& neat::ecs::engine<RegisteredComponents...>::_get_components_list() {
-    static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
-    return std::get<typing::get_index<RequestedComponent, RegisteredComponents...>()>(components._components);
+RequestedComponent* neat::ecs::archetype_engine<RegisteredComponents...>::_get_component(entity_id entity) {
+    const location_type&  location  = _locations[entity];
+    const archetype_type& archetype = _archetypes[location.archetype];
+    if (!(archetype.mask & _mask_of<RequestedComponent>()))
+        return nullptr;
+    return static_cast<RequestedComponent*>(_column_at(archetype, _index_of<RequestedComponent>(), location.row));
 }
 
 template <typename... RegisteredComponents>
-template <typename... RequestedComponents>
-std::vector<neat::ecs::entity_id> neat::ecs::engine<RegisteredComponents...>::_get_entities_who_have_components() {
-    static_assert(typing::is_subset_of<std::tuple<RequestedComponents...>, std::tuple<RegisteredComponents...>>, "At least one of the requested component types is not registered.");
-    std::vector<entity_id> found_entities;
+std::size_t neat::ecs::archetype_engine<RegisteredComponents...>::_get_archetype(std::uint64_t mask) {
+    auto found = _archetype_indices.find(mask);
+    if (found != _archetype_indices.end())
+        return found->second;
 
-    for (entity_id entity = 0; entity < entities._entities.size(); entity++) {
-        if (!entities._entities[entity])
-            continue;
+    archetype_type created;
+    created.mask      = mask;
+    created.count     = 0;
+    created.alignment = alignof(entity_id);
+    created.offsets.fill(SIZE_MAX);
 
-        bool any_not = false;
-        ([this, entity, &any_not] {
-            if (!this->_get_components_list<RequestedComponents>().has(entity)) {
-                any_not = true;
+    std::size_t row_size = sizeof(entity_id);
+    for (std::size_t column = 0; column < _columns.size(); column++) {
+        if (mask & (std::uint64_t(1) << column)) {
+            row_size += _columns[column].size;
+            created.alignment = std::max(created.alignment, _columns[column].alignment);
+        }
+    }
+
+    // Lay out the entity ids and each component array after each other, shrinking the capacity until the padding fits
+    created.capacity = std::max<std::size_t>(chunk_size / row_size, 1);
+    while (true) {
+        std::size_t offset = created.capacity * sizeof(entity_id);
+        for (std::size_t column = 0; column < _columns.size(); column++) {
+            if (mask & (std::uint64_t(1) << column)) {
+                offset                  = (offset + _columns[column].alignment - 1) / _columns[column].alignment * _columns[column].alignment;
+                created.offsets[column] = offset;
+                offset += created.capacity * _columns[column].size;
             }
-        }(),
-         ...);
-        if (!any_not) {
-            found_entities.push_back(entity);
         }
+        created.chunk_size = offset;
+        if (offset <= chunk_size || created.capacity == 1)
+            break;
+        created.capacity--;
     }
-    return found_entities;
+
+    _archetypes.push_back(std::move(created));
+    _archetype_indices[mask] = _archetypes.size() - 1;
+    return _archetypes.size() - 1;
 }
 
 template <typename... RegisteredComponents>
-template <typename... RequestedComponents>
-std::tuple<neat::ecs::entity_id, RequestedComponents*...> neat::ecs::engine<RegisteredComponents...>::_get_entity_components_with_entity(entity_id entity) {
-    return {entity, _get_components_list<RequestedComponents>().get(entity)...};
+std::size_t neat::ecs::archetype_engine<RegisteredComponents...>::_insert_row(std::size_t index, entity_id entity) {
+    archetype_type& archetype = _archetypes[index];
+    if (archetype.count == archetype.chunks.size() * archetype.capacity) {
+        archetype.chunks.push_back(static_cast<std::byte*>(::operator new(archetype.chunk_size, std::align_val_t(archetype.alignment))));
+    }
+    std::size_t row            = archetype.count++;
+    _entity_at(archetype, row) = entity;
+    return row;
 }
 
 template <typename... RegisteredComponents>
-template <typename... RequestedComponents>
-std::tuple<RequestedComponents*...> neat::ecs::engine<RegisteredComponents...>::_get_entity_components_without_entity(neat::ecs::entity_id entity) {
-    return {_get_components_list<RequestedComponents>().get(entity)...};
+void neat::ecs::archetype_engine<RegisteredComponents...>::_remove_row(std::size_t index, std::size_t row) {
+    // The components of the row must already be destroyed, the last row is moved into the hole
+    archetype_type& archetype = _archetypes[index];
+    std::size_t     last      = archetype.count - 1;
+    if (row != last) {
+        for (std::size_t column = 0; column < _columns.size(); column++) {
+            if (archetype.mask & (std::uint64_t(1) << column)) {
+                void* moved = _column_at(archetype, column, last);
+                _columns[column].move(_column_at(archetype, column, row), moved);
+                _columns[column].destroy(moved);
+            }
+        }
+        entity_id moved_entity     = _entity_at(archetype, last);
+        _entity_at(archetype, row) = moved_entity;
+        _locations[moved_entity]   = {index, row};
+    }
+    archetype.count--;
+
+    // Release the trailing empty chunks, keeping one spare so that entities moving back and forth don't reallocate it
+    std::size_t used = (archetype.count + archetype.capacity - 1) / archetype.capacity;
+    while (archetype.chunks.size() > used + 1) {
+        ::operator delete(archetype.chunks.back(), std::align_val_t(archetype.alignment));
+        archetype.chunks.pop_back();
+    }
 }
 
-#pragma endregion ecs implementations
+template <typename... RegisteredComponents>
+void neat::ecs::archetype_engine<RegisteredComponents...>::_move_entity(entity_id entity, std::size_t target) {
+    location_type source = _locations[entity];
+    std::size_t   row    = _insert_row(target, entity);
 
-#pragma region ecs entities implementations
+    const archetype_type& from = _archetypes[source.archetype];
+    const archetype_type& to   = _archetypes[target];
+    for (std::size_t column = 0; column < _columns.size(); column++) {
+        std::uint64_t bit = std::uint64_t(1) << column;
+        if (!(from.mask & bit))
+            continue;
+        void* component = _column_at(from, column, source.row);
+        if (to.mask & bit)
+            _columns[column].move(_column_at(to, column, row), component);
+        _columns[column].destroy(component);
+    }
+
+    _remove_row(source.archetype, source.row);
+    _locations[entity] = {target, row};
+}
+
+template <typename... RegisteredComponents>
+void* neat::ecs::archetype_engine<RegisteredComponents...>::_column_at(const archetype_type& archetype, std::size_t column, std::size_t row) const {
+    std::byte* chunk = archetype.chunks[row / archetype.capacity];
+    return chunk + archetype.offsets[column] + (row % archetype.capacity) * _columns[column].size;
+}
+
+template <typename... RegisteredComponents>
+neat::ecs::entity_id& neat::ecs::archetype_engine<RegisteredComponents...>::_entity_at(const archetype_type& archetype, std::size_t row) const {
+    std::byte* chunk = archetype.chunks[row / archetype.capacity];
+    return reinterpret_cast<entity_id*>(chunk)[row % archetype.capacity];
+}
+
+#pragma endregion archetype engine implementations
+
+#pragma region archetype engine entities implementations
 
 template <typename... RegisteredComponents>
-neat::ecs::engine<RegisteredComponents...>::entities::entities(engine& e)
+neat::ecs::archetype_engine<RegisteredComponents...>::entities::entities(archetype_engine& e)
     : _ecs(e) {};
 
 template <typename... RegisteredComponents>
-neat::ecs::entity_id neat::ecs::engine<RegisteredComponents...>::entities::create() {
+neat::ecs::entity_id neat::ecs::archetype_engine<RegisteredComponents...>::entities::create() {
+    entity_id entity;
     if (!_free_entities.empty()) {
-        entity_id entity = _free_entities.front();
+        entity = _free_entities.front();
         _free_entities.pop();
-        _entities[entity] = true;
-        return entity;
+        _entities.set(entity);
+    } else {
+        entity = _entities.size();
+        _entities.push_back(true);
+        _ecs._locations.push_back({});
     }
-
-    entity_id entity = _entities.size();
-    _entities.push_back(true);
+    _ecs._locations[entity] = {0, _ecs._insert_row(0, entity)};
     return entity;
 }
 
 template <typename... RegisteredComponents>
-bool neat::ecs::engine<RegisteredComponents...>::entities::remove(entity_id entity) {
+bool neat::ecs::archetype_engine<RegisteredComponents...>::entities::remove(entity_id entity) {
     if (!exists(entity))
         return false;
-    std::apply([entity](auto&&... comp) { ((comp.remove(entity)), ...); },
-               _ecs.components._components);
-    _entities[entity] = false;
+
+    location_type         location  = _ecs._locations[entity];
+    const archetype_type& archetype = _ecs._archetypes[location.archetype];
+    for (std::size_t column = 0; column < _columns.size(); column++) {
+        if (archetype.mask & (std::uint64_t(1) << column))
+            _columns[column].destroy(_ecs._column_at(archetype, column, location.row));
+    }
+    _ecs._remove_row(location.archetype, location.row);
+
+    _entities.reset(entity);
     _free_entities.push(entity);
     return true;
 }
 
 template <typename... RegisteredComponents>
-bool neat::ecs::engine<RegisteredComponents...>::entities::exists(
-    entity_id entity) const {
-    if (entity >= _ecs.entities._entities.size()) {
+bool neat::ecs::archetype_engine<RegisteredComponents...>::entities::exists(entity_id entity) const {
+    if (entity >= _entities.size()) {
         return false;
     }
-    return _ecs.entities._entities[entity];
+    return _entities.test(entity);
 }
 
 template <typename... RegisteredComponents>
-neat::ecs::entity_id neat::ecs::engine<RegisteredComponents...>::entities::last() const {
-    entity_id last = 0;
-    for (entity_id entity = 0; entity < _entities.size(); entity++) {
-        if (_entities[entity]) {
-            last = entity;
-        }
-    }
+neat::ecs::entity_id neat::ecs::archetype_engine<RegisteredComponents...>::entities::last() const {
+    entity_id last = _entities.find_last();
+    if (last >= _entities.size())
+        return 0;
     return last;
 }
 
 template <typename... RegisteredComponents>
-std::vector<neat::ecs::entity_id> neat::ecs::engine<RegisteredComponents...>::entities::all() const {
+std::vector<neat::ecs::entity_id> neat::ecs::archetype_engine<RegisteredComponents...>::entities::all() const {
     std::vector<entity_id> found_entities;
-    for (entity_id entity = 0; entity < _entities.size(); entity++) {
-        if (_entities[entity]) {
-            found_entities.push_back(entity);
-        }
+    found_entities.reserve(_entities.count());
+    for (entity_id entity = _entities.find_next(0); entity < _entities.size(); entity = _entities.find_next(entity + 1)) {
+        found_entities.push_back(entity);
     }
     return found_entities;
 }
 
-#pragma endregion ecs entities implementations
+#pragma endregion archetype engine entities implementations
 
-#pragma region ecs components implementations
+#pragma region archetype engine components implementations
 
 template <typename... RegisteredComponents>
-neat::ecs::engine<RegisteredComponents...>::components::components(engine& e)
+neat::ecs::archetype_engine<RegisteredComponents...>::components::components(archetype_engine& e)
     : _ecs(e) {};
 
 template <typename... RegisteredComponents>
 template <typename RequestedComponent>
-RequestedComponent* neat::ecs::engine<RegisteredComponents...>::components::get(entity_id entity) {
+RequestedComponent* neat::ecs::archetype_engine<RegisteredComponents...>::components::get(entity_id entity) {
     static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
     if (!_ecs.entities.exists(entity))
         return nullptr;
-    return _ecs._get_components_list<RequestedComponent>().get(entity);
+    return _ecs._get_component<RequestedComponent>(entity);
 }
 
 template <typename... RegisteredComponents>
 template <typename RequestedComponent>
-std::vector<RequestedComponent*> neat::ecs::engine<RegisteredComponents...>::components::get(const std::vector<entity_id>& entity_list) {
+std::vector<RequestedComponent*> neat::ecs::archetype_engine<RegisteredComponents...>::components::get(const std::vector<entity_id>& entity_list) {
     static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
     std::vector<RequestedComponent*> result;
     result.reserve(entity_list.size());
@@ -396,63 +5304,69 @@ std::vector<RequestedComponent*> neat::ecs::engine<RegisteredComponents...>::com
 
 template <typename... RegisteredComponents>
 template <typename RequestedComponent, typename... Args>
-RequestedComponent* neat::ecs::engine<RegisteredComponents...>::components::add(entity_id entity, Args... args) {
+RequestedComponent* neat::ecs::archetype_engine<RegisteredComponents...>::components::add(entity_id entity, Args&&... args) {
     static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
+    static_assert(std::is_constructible_v<RequestedComponent, Args...>, "Component type can't be built from given arguments.");
     if (!_ecs.entities.exists(entity))
         return nullptr;
-    return _ecs._get_components_list<RequestedComponent>().add(entity, args...);
-}
 
-template <typename... RegisteredComponents>
-template <typename RequestedComponent>
-bool neat::ecs::engine<RegisteredComponents...>::components::has(entity_id entity) const {
-    static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
-    if (!_ecs.entities.exists(entity))
-        return false;
-    return _ecs._get_components_list<RequestedComponent>().has(entity);
+    RequestedComponent* existing = _ecs._get_component<RequestedComponent>(entity);
+    if (existing != nullptr) {
+        *existing = RequestedComponent(std::forward<Args>(args)...);
+        return existing;
+    }
+
+    RequestedComponent component(std::forward<Args>(args)...);
+    std::size_t        target = _ecs._get_archetype(_ecs._archetypes[_ecs._locations[entity].archetype].mask | _mask_of<RequestedComponent>());
+    _ecs._move_entity(entity, target);
+
+    void* destination = _ecs._column_at(_ecs._archetypes[target], _index_of<RequestedComponent>(), _ecs._locations[entity].row);
+    return new (destination) RequestedComponent(std::move(component));
 }
 
 template <typename... RegisteredComponents>
 template <typename RequestedComponent>
-bool neat::ecs::engine<RegisteredComponents...>::components::remove(entity_id entity) {
+bool neat::ecs::archetype_engine<RegisteredComponents...>::components::has(entity_id entity) const {
     static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
     if (!_ecs.entities.exists(entity))
         return false;
-    return _ecs._get_components_list<RequestedComponent>().remove(entity);
+    return _ecs._archetypes[_ecs._locations[entity].archetype].mask & _mask_of<RequestedComponent>();
 }
 
 template <typename... RegisteredComponents>
 template <typename RequestedComponent>
-std::tuple<neat::ecs::entity_id, RequestedComponent*> neat::ecs::engine<RegisteredComponents...>::components::first() {
+bool neat::ecs::archetype_engine<RegisteredComponents...>::components::remove(entity_id entity) {
     static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
-    return _ecs._get_components_list<RequestedComponent>().first();
+    if (!has<RequestedComponent>(entity))
+        return false;
+    std::size_t target = _ecs._get_archetype(_ecs._archetypes[_ecs._locations[entity].archetype].mask & ~_mask_of<RequestedComponent>());
+    _ecs._move_entity(entity, target);
+    return true;
 }
 
 template <typename... RegisteredComponents>
 template <typename RequestedComponent>
-bool neat::ecs::engine<RegisteredComponents...>::components::allocate(size_t new_size) {
+std::tuple<neat::ecs::entity_id, RequestedComponent*> neat::ecs::archetype_engine<RegisteredComponents...>::components::first() {
     static_assert(typing::is_one_of<RequestedComponent, RegisteredComponents...>, "Requested component type is not registered.");
-    return _ecs._get_components_list<RequestedComponent>().allocate(new_size);
-}
-
-template <typename... RegisteredComponents>
-bool neat::ecs::engine<RegisteredComponents...>::components::allocate_all(size_t new_size) {
-    bool allocated = false;
-    std::apply([new_size, &allocated](auto&&... comp) { ((allocated = allocated || comp.allocate(new_size)), ...); }, _ecs.components._components);
-    return allocated;
+    std::tuple<entity_id, RequestedComponent*> found = {invalid_entity, nullptr};
+    for (auto [entity, component] : _ecs.template iterate<RequestedComponent>()) {
+        if (entity < std::get<0>(found))
+            found = {entity, component};
+    }
+    return found;
 }
 
-#pragma endregion ecs component implementations
+#pragma endregion archetype engine components implementations
 
-#pragma region ecs system implementations
+#pragma region archetype engine systems implementations
 
 template <typename... RegisteredComponents>
-neat::ecs::engine<RegisteredComponents...>::systems::systems(engine& e)
+neat::ecs::archetype_engine<RegisteredComponents...>::systems::systems(archetype_engine& e)
     : _ecs(e) {};
 
 template <typename... RegisteredComponents>
 template <typename... FuncComponents>
-void neat::ecs::engine<RegisteredComponents...>::systems::execute(void (&system)(entity_id, FuncComponents*...)) {
+void neat::ecs::archetype_engine<RegisteredComponents...>::systems::execute(void (&system)(entity_id, FuncComponents*...)) {
     for (auto data : _ecs.iterate<FuncComponents...>()) {
         std::apply(system, data);
     }
@@ -460,7 +5374,7 @@ void neat::ecs::engine<RegisteredComponents...>::systems::execute(void (&system)
 
 template <typename... RegisteredComponents>
 template <typename... FuncComponents>
-void neat::ecs::engine<RegisteredComponents...>::systems::execute(void (&system)(FuncComponents*...)) {
+void neat::ecs::archetype_engine<RegisteredComponents...>::systems::execute(void (&system)(FuncComponents*...)) {
     for (auto data : _ecs.iterate_components<FuncComponents...>()) {
         std::apply(system, data);
     }
@@ -468,7 +5382,7 @@ void neat::ecs::engine<RegisteredComponents...>::systems::execute(void (&system)
 
 template <typename... RegisteredComponents>
 template <typename... FuncComponents>
-void neat::ecs::engine<RegisteredComponents...>::systems::execute(void (&system)(engine<RegisteredComponents...>&, entity_id, FuncComponents*...)) {
+void neat::ecs::archetype_engine<RegisteredComponents...>::systems::execute(void (&system)(archetype_engine<RegisteredComponents...>&, entity_id, FuncComponents*...)) {
     for (auto data : _ecs.iterate<FuncComponents...>()) {
         std::apply(system, std::tuple_cat(std::tie(this->_ecs), data));
     }
@@ -476,12 +5390,12 @@ void neat::ecs::engine<RegisteredComponents...>::systems::execute(void (&system)
 
 template <typename... RegisteredComponents>
 template <typename... FuncComponents>
-void neat::ecs::engine<RegisteredComponents...>::systems::execute(void (&system)(engine<RegisteredComponents...>&, FuncComponents*...)) {
+void neat::ecs::archetype_engine<RegisteredComponents...>::systems::execute(void (&system)(archetype_engine<RegisteredComponents...>&, FuncComponents*...)) {
     for (auto data : _ecs.iterate_components<FuncComponents...>()) {
         std::apply(system, std::tuple_cat(std::tie(this->_ecs), data));
     }
 }
 
-#pragma endregion ecs systems implementations
+#pragma endregion archetype engine systems implementations
 
 #endif  // NEAT_ECS_HPP_
\ No newline at end of file
@@ -1,3 +1,4 @@
+#include <vector>
 #include <neat/allocators.hpp>
 #include <neat/test.hpp>
 
@@ -60,9 +61,47 @@ void test_bump_small(void) {
     NEAT_TEST_ASSERT(bump2.block_count() == 1);
 }
 
+void test_bump_aligned(void) {
+    neat::allocators::bump bump(64);
+
+    char*   a = bump.allocate<char>();
+    double* b = bump.allocate<double>();
+    void*   c = bump.allocate(8, 32);
+
+    NEAT_TEST_ASSERT(a != nullptr);
+    NEAT_TEST_ASSERT(b != nullptr);
+    NEAT_TEST_ASSERT(c != nullptr);
+    NEAT_TEST_ASSERT(reinterpret_cast<std::uintptr_t>(b) % alignof(double) == 0);
+    NEAT_TEST_ASSERT(reinterpret_cast<std::uintptr_t>(c) % 32 == 0);
+    NEAT_TEST_ASSERT(bump.allocate(65, 1) == nullptr);
+}
+
+void test_bump_resource(void) {
+    neat::allocators::bump          bump(1024);
+    neat::allocators::bump_resource resource(bump);
+
+    std::pmr::vector<int> values(&resource);
+    for (int i = 0; i < 100; i++) {
+        values.push_back(i);
+    }
+    NEAT_TEST_ASSERT(values.size() == 100);
+    NEAT_TEST_ASSERT(values[99] == 99);
+    NEAT_TEST_ASSERT(bump.block_count() >= 1);
+
+    bool failed = false;
+    try {
+        failed = resource.allocate(2048) == nullptr;
+    } catch (const std::bad_alloc&) {
+        failed = true;
+    }
+    NEAT_TEST_ASSERT(failed);
+}
+
 int main() {
     NEAT_TEST_RUN(test_arena_small_ints);
     NEAT_TEST_RUN(test_bump_small);
+    NEAT_TEST_RUN(test_bump_aligned);
+    NEAT_TEST_RUN(test_bump_resource);
 
     NEAT_TEST_PRINT_STATS();
 }
\ No newline at end of file
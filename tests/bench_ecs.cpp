@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <neat/ecs.hpp>
+#include <random>
+#include <vector>
+
+// Benchmarks of the ECS, printed as one JSON object per line:
+// {"benchmark":"iterate_multi","entities":100000,"sparsity":0.1,"ns_per_entity":1.23}
+//
+// The time is divided by the amount of entities in the engine, also for benchmarks which only touch a fraction of them.
+// The largest entity count can be given as argument, by default 10k, 100k and 1M entities are measured.
+
+struct Position {
+    float x, y;
+};
+
+struct Velocity {
+    float x, y;
+};
+
+struct Marked {
+    int value;
+};
+
+template <>
+struct neat::ecs::component_traits<Marked> {
+    using storage = neat::ecs::sparse_storage;
+};
+
+using bench_ecs = neat::ecs::engine<Position, Velocity, Marked>;
+using clock_type = std::chrono::steady_clock;
+
+constexpr int repetitions = 5;
+
+volatile float sink = 0.0f;  // Keeps the results of iteration from being optimized away
+
+// Runs setup and the measured function a few times, and reports the fastest run
+template <typename Setup, typename Function>
+void measure(const char* name, std::size_t count, double sparsity, Setup&& setup, Function&& function) {
+    double best = 0.0;
+    for (int repetition = 0; repetition < repetitions; repetition++) {
+        auto ecs = std::make_unique<bench_ecs>();
+        setup(*ecs);
+        auto start = clock_type::now();
+        function(*ecs);
+        double elapsed = std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+        if (repetition == 0 || elapsed < best)
+            best = elapsed;
+    }
+    std::printf("{\"benchmark\":\"%s\",\"entities\":%zu,\"sparsity\":%g,\"ns_per_entity\":%.3f}\n", name, count, sparsity, best / static_cast<double>(count));
+    std::fflush(stdout);
+}
+
+// Entities which get the optional components, a random fraction of all entities
+std::vector<neat::ecs::entity_id> pick(std::size_t count, double sparsity) {
+    std::vector<neat::ecs::entity_id> picked;
+    std::mt19937                      random(42);
+    std::bernoulli_distribution       chance(sparsity);
+    for (neat::ecs::entity_id entity = 0; entity < count; entity++) {
+        if (chance(random))
+            picked.push_back(entity);
+    }
+    return picked;
+}
+
+void populate(bench_ecs& ecs, std::size_t count, const std::vector<neat::ecs::entity_id>& picked) {
+    for (neat::ecs::entity_id entity : ecs.entities.create_many(count)) {
+        ecs.components.add<Position>(entity, 0.0f, 0.0f);
+    }
+    for (neat::ecs::entity_id entity : picked) {
+        ecs.components.add<Velocity>(entity, 1.0f, 2.0f);
+        ecs.components.add<Marked>(entity, 1);
+    }
+}
+
+void move(Position* position, const Velocity* velocity) {
+    position->x += velocity->x;
+    position->y += velocity->y;
+}
+
+void bench_entities(std::size_t count) {
+    measure("create", count, 1.0, [](bench_ecs&) {}, [count](bench_ecs& ecs) {
+        for (std::size_t index = 0; index < count; index++) {
+            ecs.entities.create();
+        }
+    });
+    measure("create_many", count, 1.0, [](bench_ecs&) {}, [count](bench_ecs& ecs) {
+        ecs.entities.create_many(count);
+    });
+    measure("destroy", count, 1.0, [count](bench_ecs& ecs) { populate(ecs, count, {}); }, [count](bench_ecs& ecs) {
+        for (neat::ecs::entity_id entity = 0; entity < count; entity++) {
+            ecs.entities.remove(entity);
+        }
+    });
+}
+
+void bench_components(std::size_t count, double sparsity) {
+    std::vector<neat::ecs::entity_id> picked = pick(count, sparsity);
+    auto                              setup  = [&](bench_ecs& ecs) { populate(ecs, count, {}); };
+    auto                              filled = [&](bench_ecs& ecs) { populate(ecs, count, picked); };
+
+    measure("add_component", count, sparsity, setup, [&](bench_ecs& ecs) {
+        for (neat::ecs::entity_id entity : picked) {
+            ecs.components.add<Velocity>(entity, 1.0f, 2.0f);
+        }
+    });
+    measure("remove_component", count, sparsity, filled, [&](bench_ecs& ecs) {
+        for (neat::ecs::entity_id entity : picked) {
+            ecs.components.remove<Velocity>(entity);
+        }
+    });
+    measure("add_sparse_component", count, sparsity, setup, [&](bench_ecs& ecs) {
+        for (neat::ecs::entity_id entity : picked) {
+            ecs.components.add<Marked>(entity, 1);
+        }
+    });
+    measure("remove_sparse_component", count, sparsity, filled, [&](bench_ecs& ecs) {
+        for (neat::ecs::entity_id entity : picked) {
+            ecs.components.remove<Marked>(entity);
+        }
+    });
+}
+
+void bench_iteration(std::size_t count, double sparsity) {
+    std::vector<neat::ecs::entity_id> picked = pick(count, sparsity);
+    auto                              setup  = [&](bench_ecs& ecs) { populate(ecs, count, picked); };
+
+    measure("iterate_single", count, sparsity, setup, [](bench_ecs& ecs) {
+        float sum = 0.0f;
+        for (auto [entity, velocity] : ecs.iterate<Velocity>()) {
+            sum += velocity->x;
+        }
+        sink = sum;
+    });
+    measure("iterate_multi", count, sparsity, setup, [](bench_ecs& ecs) {
+        float sum = 0.0f;
+        for (auto [entity, position, velocity] : ecs.iterate<Position, Velocity>()) {
+            sum += position->x + velocity->x;
+        }
+        sink = sum;
+    });
+    measure("iterate_sparse", count, sparsity, setup, [](bench_ecs& ecs) {
+        float sum = 0.0f;
+        for (auto [entity, position, marked] : ecs.iterate<Position, Marked>()) {
+            sum += position->x + static_cast<float>(marked->value);
+        }
+        sink = sum;
+    });
+    measure("execute", count, sparsity, setup, [](bench_ecs& ecs) {
+        ecs.systems.execute(move);
+        sink = ecs.components.get<Position>(0)->x;
+    });
+}
+
+int main(int argc, char** argv) {
+    std::size_t largest = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    for (std::size_t count : {std::size_t(10000), std::size_t(100000), std::size_t(1000000)}) {
+        if (count > largest)
+            break;
+        bench_entities(count);
+        for (double sparsity : {1.0, 0.5, 0.1, 0.01}) {
+            bench_components(count, sparsity);
+            bench_iteration(count, sparsity);
+        }
+    }
+}
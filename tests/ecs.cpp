@@ -1,4 +1,10 @@
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <neat/allocators.hpp>
 #include <neat/ecs.hpp>
 #include <neat/test.hpp>
 
@@ -14,6 +20,72 @@ struct C {
     int c = 0;
 };
 
+struct Rare {
+    int rare = 0;
+};
+
+template <>
+struct neat::ecs::component_traits<Rare> {
+    using storage = neat::ecs::sparse_storage;
+};
+
+// Move-only component without a default constructor, counting the living objects
+struct Tracked {
+    static inline int alive = 0;
+    std::string       name;
+
+    explicit Tracked(std::string value)
+        : name(std::move(value)) { alive++; }
+    Tracked(Tracked&& other) noexcept
+        : name(std::move(other.name)) { alive++; }
+    Tracked(const Tracked&)            = delete;
+    Tracked& operator=(Tracked&&)      = default;
+    Tracked& operator=(const Tracked&) = delete;
+    ~Tracked() { alive--; }
+};
+
+// Component which can't be assigned or default constructed
+struct Fixed {
+    const int id;
+};
+
+struct FixedRare {
+    const int id;
+};
+
+template <>
+struct neat::ecs::component_traits<FixedRare> {
+    using storage = neat::ecs::sparse_storage;
+};
+
+struct TrackedRare : Tracked {
+    using Tracked::Tracked;
+};
+
+template <>
+struct neat::ecs::component_traits<TrackedRare> {
+    using storage = neat::ecs::sparse_storage;
+};
+
+struct Moved {
+    int x = 0;
+};
+
+template <>
+struct neat::ecs::component_traits<Moved> {
+    static constexpr bool track_changes = true;
+};
+
+struct Spotted {
+    int by = 0;
+};
+
+template <>
+struct neat::ecs::component_traits<Spotted> {
+    using storage                       = neat::ecs::sparse_storage;
+    static constexpr bool track_changes = true;
+};
+
 using ecs = neat::ecs::engine<A, B, C>;
 
 void test_deleted_entity_no_longer_exists() {
@@ -102,6 +174,11 @@ void test_system_types_func4(ecs&, neat::ecs::entity_id, A* a) {
     a->a += 0b1000;
 }
 
+void test_system_parallel_func(neat::ecs::entity_id entity, A* a, B* b) {
+    a->a += static_cast<int>(entity);
+    b->b += 1;
+}
+
 void test_system_types() {
     ecs ecs;
 
@@ -117,12 +194,1305 @@ void test_system_types() {
     NEAT_TEST_ASSERT(a->a == 0b1111);
 }
 
+void test_iterate_is_lazy_view() {
+    ecs ecs;
+
+    auto e1 = ecs.entities.create();
+    auto e2 = ecs.entities.create();
+    auto e3 = ecs.entities.create();
+    auto e4 = ecs.entities.create();
+
+    ecs.components.add<A>(e1, 1);
+    ecs.components.add<A>(e2, 2);
+    ecs.components.add<B>(e2, 20);
+    ecs.components.add<A>(e4, 4);
+    ecs.components.add<B>(e4, 40);
+    ecs.components.add<B>(e3, 30);
+
+    auto view = ecs.iterate<A, B>();
+    static_assert(std::ranges::forward_range<decltype(view)>);
+    static_assert(std::ranges::view<decltype(view)>);
+
+    std::vector<neat::ecs::entity_id> found;
+    for (auto [entity, a, b] : view) {
+        NEAT_TEST_ASSERT(a->a * 10 == b->b);
+        found.push_back(entity);
+    }
+    NEAT_TEST_ASSERT(found.size() == 2);
+    NEAT_TEST_ASSERT(found[0] == e2);
+    NEAT_TEST_ASSERT(found[1] == e4);
+
+    // The view is evaluated lazily, so later changes are visible
+    ecs.components.remove<B>(e2);
+    NEAT_TEST_ASSERT(std::ranges::distance(view) == 1);
+    NEAT_TEST_ASSERT(std::ranges::count_if(ecs.iterate_components<A>(), [](auto t) { return std::get<0>(t)->a > 1; }) == 2);
+    NEAT_TEST_ASSERT(ecs.iterate<C>().empty());
+}
+
+void test_iterate_sparse_across_words() {
+    ecs ecs;
+
+    for (int i = 0; i < 1000; i++) {
+        auto e = ecs.entities.create();
+        if (i % 7 == 0)
+            ecs.components.add<A>(e, i);
+        if (i % 3 == 0)
+            ecs.components.add<B>(e, i);
+    }
+    ecs.entities.remove(0);
+
+    std::vector<neat::ecs::entity_id> found;
+    for (auto [entity, a, b] : ecs.iterate<A, B>()) {
+        NEAT_TEST_ASSERT(a->a == b->b);
+        found.push_back(entity);
+    }
+
+    std::vector<neat::ecs::entity_id> expected;
+    for (neat::ecs::entity_id e = 21; e < 1000; e += 21) {
+        expected.push_back(e);
+    }
+    NEAT_TEST_ASSERT(found == expected);
+    NEAT_TEST_ASSERT(ecs.entities.all().size() == 999);
+    NEAT_TEST_ASSERT(ecs.entities.last() == 999);
+    NEAT_TEST_ASSERT(std::get<0>(ecs.components.first<A>()) == 7);
+}
+
+void test_iterate_selective_driver() {
+    ecs ecs;
+
+    // A few entities with A among many entities with B, spread over several summary blocks
+    std::vector<neat::ecs::entity_id> expected;
+    for (int i = 0; i < 20000; i++) {
+        auto e = ecs.entities.create();
+        ecs.components.add<B>(e, i);
+        if (i % 4999 == 3) {
+            ecs.components.add<A>(e, i);
+            expected.push_back(e);
+        }
+    }
+    ecs.components.add<A>(ecs.entities.create(), -1);  // Has no B component
+
+    std::vector<neat::ecs::entity_id> found;
+    for (auto [entity, a, b] : ecs.iterate<A, B>()) {
+        NEAT_TEST_ASSERT(a->a == b->b);
+        found.push_back(entity);
+    }
+    NEAT_TEST_ASSERT(found == expected);
+
+    ecs.components.remove<A>(expected[1]);
+    expected.erase(expected.begin() + 1);
+    found.clear();
+    for (auto [entity, b, a] : ecs.iterate<B, A>()) {
+        found.push_back(entity);
+    }
+    NEAT_TEST_ASSERT(found == expected);
+
+    auto none = ecs.iterate<C, B>();
+    NEAT_TEST_ASSERT(none.begin() == none.end());
+}
+
+void test_query_filters() {
+    neat::ecs::engine<A, B, C, Rare> ecs;
+
+    for (int i = 0; i < 300; i++) {
+        auto e = ecs.entities.create();
+        ecs.components.add<A>(e, i);
+        if (i % 2 == 0)
+            ecs.components.add<B>(e, i);
+        if (i % 3 == 0)
+            ecs.components.add<C>(e, i);
+        if (i % 10 == 0)
+            ecs.components.add<Rare>(e, i);
+    }
+
+    int count = 0;
+    for (auto [entity, a, b] : ecs.iterate<A, neat::ecs::without<C>, neat::ecs::optional<B>>()) {
+        NEAT_TEST_ASSERT(entity % 3 != 0);
+        NEAT_TEST_ASSERT((b != nullptr) == (entity % 2 == 0));
+        NEAT_TEST_ASSERT(a->a == static_cast<int>(entity));
+        count++;
+    }
+    NEAT_TEST_ASSERT(count == 200);
+
+    // All entities with Rare also have A and B
+    auto without_b = ecs.iterate_components<neat::ecs::with<Rare>, A, neat::ecs::without<B>>();
+    auto without_a = ecs.iterate<Rare, neat::ecs::optional<C>, neat::ecs::without<A>>();
+    NEAT_TEST_ASSERT(without_b.begin() == without_b.end());
+    NEAT_TEST_ASSERT(without_a.begin() == without_a.end());
+
+    count = 0;
+    for (auto [entity, rare, c] : ecs.iterate<Rare, neat::ecs::optional<C>>()) {
+        NEAT_TEST_ASSERT(rare->rare == static_cast<int>(entity));
+        NEAT_TEST_ASSERT((c != nullptr) == (entity % 30 == 0));
+        count++;
+    }
+    NEAT_TEST_ASSERT(count == 30);
+
+    neat::ecs::archetype_engine<A, B, C> archetypes;
+    for (int i = 0; i < 300; i++) {
+        auto e = archetypes.entities.create();
+        archetypes.components.add<A>(e, i);
+        if (i % 2 == 0)
+            archetypes.components.add<B>(e, i);
+        if (i % 3 == 0)
+            archetypes.components.add<C>(e, i);
+    }
+
+    count = 0;
+    for (auto [entity, a, b] : archetypes.iterate<A, neat::ecs::without<C>, neat::ecs::optional<B>>()) {
+        NEAT_TEST_ASSERT(entity % 3 != 0);
+        NEAT_TEST_ASSERT((b != nullptr) == (entity % 2 == 0));
+        NEAT_TEST_ASSERT(a->a == static_cast<int>(entity));
+        count++;
+    }
+    NEAT_TEST_ASSERT(count == 200);
+}
+
+void test_sparse_storage() {
+    neat::ecs::engine<A, Rare> ecs;
+
+    std::vector<neat::ecs::entity_id> entities;
+    for (int i = 0; i < 100; i++) {
+        auto e = ecs.entities.create();
+        ecs.components.add<A>(e, i);
+        entities.push_back(e);
+    }
+    ecs.components.add<Rare>(entities[90], 90);
+    ecs.components.add<Rare>(entities[10], 10);
+    ecs.components.add<Rare>(entities[50], 50);
+
+    NEAT_TEST_ASSERT(ecs.components.has<Rare>(entities[10]));
+    NEAT_TEST_ASSERT(not ecs.components.has<Rare>(entities[11]));
+    NEAT_TEST_ASSERT(ecs.components.get<Rare>(entities[50])->rare == 50);
+    NEAT_TEST_ASSERT(std::get<0>(ecs.components.first<Rare>()) == entities[10]);
+
+    int visited = 0;
+    for (auto [entity, a, rare] : ecs.iterate<A, Rare>()) {
+        NEAT_TEST_ASSERT(a->a == rare->rare);
+        NEAT_TEST_ASSERT(entity == entities[rare->rare]);
+        visited++;
+    }
+    NEAT_TEST_ASSERT(visited == 3);
+
+    NEAT_TEST_ASSERT(ecs.components.remove<Rare>(entities[90]));
+    NEAT_TEST_ASSERT(not ecs.components.remove<Rare>(entities[90]));
+    NEAT_TEST_ASSERT(ecs.entities.remove(entities[10]));
+    NEAT_TEST_ASSERT(ecs.components.get<Rare>(entities[50])->rare == 50);
+
+    auto remaining = ecs.iterate<Rare>();
+    NEAT_TEST_ASSERT(std::ranges::distance(remaining) == 1);
+    NEAT_TEST_ASSERT(std::get<0>(remaining.front()) == entities[50]);
+
+    // Allocating only grows the index, the packed components grow with the components that are added
+    neat::ecs::engine<A, Rare> allocated;
+    allocated.components.allocate_all(100000);
+    allocated.components.add_many<Rare>(allocated.entities.create_many(20), Rare {1});
+    neat::ecs::memory_report report = allocated.memory_stats();
+    NEAT_TEST_ASSERT(report.components[0].capacity == 100000);
+    NEAT_TEST_ASSERT(report.components[1].count == 20);
+    NEAT_TEST_ASSERT(report.components[1].capacity < 100);
+}
+
+struct Name {
+    std::string name;
+};
+
+template <>
+struct neat::ecs::component_traits<Name> {
+    static void save(std::ostream& out, const Name& value) {
+        std::uint64_t size = value.name.size();
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        out.write(value.name.data(), static_cast<std::streamsize>(size));
+    }
+
+    static Name load(std::istream& in) {
+        std::uint64_t size = 0;
+        in.read(reinterpret_cast<char*>(&size), sizeof(size));
+        std::string name(size, '\0');
+        in.read(name.data(), static_cast<std::streamsize>(size));
+        return {std::move(name)};
+    }
+};
+
+void test_archetype_engine() {
+    neat::ecs::archetype_engine<A, B, Name> ecs;
+
+    std::vector<neat::ecs::entity_id> entities;
+    for (int i = 0; i < 5000; i++) {
+        auto e = ecs.entities.create();
+        ecs.components.add<A>(e, i);
+        if (i % 2 == 0)
+            ecs.components.add<B>(e, i);
+        if (i % 5 == 0)
+            ecs.components.add<Name>(e, std::to_string(i));
+        entities.push_back(e);
+    }
+    NEAT_TEST_ASSERT(ecs.archetype_count() == 5);  // {}, {A}, {A, B}, {A, Name}, {A, B, Name}
+
+    int visited = 0;
+    for (auto [entity, a, b] : ecs.iterate<A, B>()) {
+        NEAT_TEST_ASSERT(a->a == b->b);
+        NEAT_TEST_ASSERT(entity == entities[a->a]);
+        visited++;
+    }
+    NEAT_TEST_ASSERT(visited == 2500);
+
+    // Moving entities between archetypes keeps their components
+    NEAT_TEST_ASSERT(ecs.components.remove<B>(entities[10]));
+    NEAT_TEST_ASSERT(not ecs.components.has<B>(entities[10]));
+    NEAT_TEST_ASSERT(ecs.components.get<A>(entities[10])->a == 10);
+    NEAT_TEST_ASSERT(ecs.components.get<Name>(entities[10])->name == "10");
+    NEAT_TEST_ASSERT(ecs.components.get<Name>(entities[20])->name == "20");
+
+    NEAT_TEST_ASSERT(ecs.entities.remove(entities[0]));
+    NEAT_TEST_ASSERT(not ecs.components.has<A>(entities[0]));
+    NEAT_TEST_ASSERT(std::get<0>(ecs.components.first<Name>()) == entities[5]);
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<Name>()) == 999);
+    for (auto [a, name] : ecs.iterate_components<A, Name>()) {
+        NEAT_TEST_ASSERT(name->name == std::to_string(a->a));
+    }
+
+    ecs.systems.execute(test_system_types_func1);
+    NEAT_TEST_ASSERT(ecs.components.get<A>(entities[1])->a == 2);
+}
+
+void test_execute_parallel() {
+    ecs                    ecs;
+    neat::ecs::thread_pool pool(4);
+    neat::ecs::entity_id   count = 100000;
+
+    for (neat::ecs::entity_id i = 0; i < count; i++) {
+        auto e = ecs.entities.create();
+        ecs.components.add<A>(e);
+        if (i % 3 != 0)
+            ecs.components.add<B>(e);
+    }
+
+    ecs.systems.execute_parallel(pool, test_system_parallel_func, 256);
+    ecs.systems.execute_parallel(pool, test_system_types_func1);
+
+    bool all_correct = true;
+    for (auto [entity, a] : ecs.iterate<A>()) {
+        bool has_b = entity % 3 != 0;
+        all_correct &= a->a == (has_b ? static_cast<int>(entity) : 0) + 1;
+        all_correct &= !has_b || ecs.components.get<B>(entity)->b == 1;
+    }
+    NEAT_TEST_ASSERT(all_correct);
+    NEAT_TEST_ASSERT(pool.thread_count() == 4);
+
+    bool thrown = false;
+    try {
+        pool.parallel_for(0, 100, 1, [](std::size_t first, std::size_t) {
+            if (first == 50)
+                throw first;
+        });
+    } catch (std::size_t) {
+        thrown = true;
+    }
+    NEAT_TEST_ASSERT(thrown);
+}
+
+std::atomic<int> test_batches_called = 0;
+std::atomic<int> test_batches_entities = 0;
+
+void test_batches_add_b_to_a(std::span<const neat::ecs::entity_id> entities, std::span<A> a, std::span<const B> b) {
+    for (std::size_t i = 0; i < a.size(); i++) {
+        a[i].a += b[i].b;
+    }
+    test_batches_called++;
+    test_batches_entities += static_cast<int>(entities.size());
+}
+
+void test_batches_rare(std::span<const neat::ecs::entity_id> entities, std::span<Rare> rare) {
+    for (std::size_t i = 0; i < rare.size(); i++) {
+        rare[i].rare = static_cast<int>(entities[i]);
+    }
+    test_batches_called++;
+}
+
+void test_execute_batched() {
+    neat::ecs::engine<A, B, Rare> ecs;
+    for (int i = 0; i < 10000; i++) {
+        auto entity = ecs.entities.create();
+        ecs.components.add<A>(entity, 1);
+        if (i % 1000 != 999)
+            ecs.components.add<B>(entity, i);
+        if (i < 100)
+            ecs.components.add<Rare>(entity);
+    }
+
+    // Every run of consecutive entities is split into batches of at most 512 entities
+    ecs.systems.execute_batched(test_batches_add_b_to_a, 512);
+    NEAT_TEST_ASSERT(test_batches_entities == 9990);
+    NEAT_TEST_ASSERT(test_batches_called == 20);
+    NEAT_TEST_ASSERT(ecs.components.get<A>(998)->a == 999);
+    NEAT_TEST_ASSERT(ecs.components.get<A>(999)->a == 1);
+
+    neat::ecs::thread_pool pool(4);
+    test_batches_entities = 0;
+    ecs.systems.execute_batched_parallel(pool, test_batches_add_b_to_a, 256);
+    NEAT_TEST_ASSERT(test_batches_entities == 9990);
+    NEAT_TEST_ASSERT(ecs.components.get<A>(9998)->a == 1 + 2 * 9998);
+
+    // Sparse components are batched while their packed components are contiguous
+    test_batches_called = 0;
+    ecs.components.remove<Rare>(50);
+    ecs.systems.execute_batched(test_batches_rare);
+    NEAT_TEST_ASSERT(test_batches_called > 1);
+    NEAT_TEST_ASSERT(ecs.components.get<Rare>(99)->rare == 99);
+    NEAT_TEST_ASSERT(ecs.components.get<Rare>(0)->rare == 0);
+    NEAT_TEST_ASSERT(ecs.components.get<Rare>(50) == nullptr);
+}
+
+// Function object receiving a component as read-only
+struct test_sum_b {
+    int& sum;
+    void operator()(const B* b) const { sum += b->b; }
+};
+
+void test_execute_callables() {
+    ecs ecs;
+    for (int i = 0; i < 100; i++) {
+        auto entity = ecs.entities.create();
+        ecs.components.add<A>(entity, i);
+        if (i % 2 == 0)
+            ecs.components.add<B>(entity, 1);
+    }
+
+    // Capturing lambdas and function objects, with the components deduced from their signature
+    int offset = 10;
+    ecs.systems.execute([offset](A* a, const B* b) { a->a += offset * b->b; });
+    NEAT_TEST_ASSERT(ecs.components.get<A>(2)->a == 12);
+    NEAT_TEST_ASSERT(ecs.components.get<A>(3)->a == 3);
+
+    int sum = 0;
+    ecs.systems.execute(test_sum_b {sum});
+    NEAT_TEST_ASSERT(sum == 50);
+
+    int visited = 0;
+    ecs.systems.execute([&visited](neat::ecs::entity_id entity, A* a) mutable noexcept { visited += a->a == static_cast<int>(entity); });
+    NEAT_TEST_ASSERT(visited == 50);
+
+    std::vector<neat::ecs::entity_id> removed;
+    ecs.systems.execute([&removed](::ecs& engine, neat::ecs::entity_id entity, const A*, const B*) {
+        if (engine.components.has<C>(entity) == false)
+            removed.push_back(entity);
+    });
+    NEAT_TEST_ASSERT(removed.size() == 50);
+
+    neat::ecs::thread_pool pool(4);
+    std::atomic<int>       total = 0;
+    ecs.systems.execute_parallel(pool, [&total](const A* a) { total += a->a; }, 16);
+    NEAT_TEST_ASSERT(total == 4950 + 500);
+
+    // The scheduler keeps a copy of the lambda, and derives its access from the signature
+    int  runs     = 0;
+    auto counting = [&runs](const C*) { runs++; };
+    ecs.scheduler.add(counting);
+    ecs.scheduler.add([](A* a) { a->a = 0; });
+    ecs.scheduler.add([](const B*) {});
+    NEAT_TEST_ASSERT(ecs.scheduler.schedule().size() == 1);
+    ecs.scheduler.run(pool);
+    NEAT_TEST_ASSERT(ecs.components.get<A>(99)->a == 0);
+}
+
+struct Time {
+    int delta = 0;
+    int frame = 0;
+};
+
+template <>
+struct neat::ecs::component_traits<Time> {
+    using storage = neat::ecs::singleton_storage;
+};
+
+struct Motd {
+    std::string text;
+};
+
+template <>
+struct neat::ecs::component_traits<Motd> {
+    using storage = neat::ecs::singleton_storage;
+};
+
+void test_singleton_apply_time(const Time* time, A* a) {
+    a->a += time->delta;
+}
+
+void test_singleton_components() {
+    neat::ecs::engine<A, B, Time> ecs;
+    for (int i = 0; i < 10; i++) {
+        auto entity = ecs.entities.create();
+        ecs.components.add<A>(entity, i);
+        if (i < 5)
+            ecs.components.add<B>(entity);
+    }
+
+    // Systems receiving a singleton do not run until it is set
+    ecs.systems.execute(test_singleton_apply_time);
+    NEAT_TEST_ASSERT(ecs.components.get<Time>() == nullptr);
+    NEAT_TEST_ASSERT(ecs.components.get<A>(9)->a == 9);
+
+    Time* time = ecs.components.set<Time>(5);
+    NEAT_TEST_ASSERT(ecs.components.get<Time>() == time && time->delta == 5);
+    ecs.systems.execute(test_singleton_apply_time);
+    NEAT_TEST_ASSERT(ecs.components.get<A>(9)->a == 14);
+
+    // The singleton is shared by all entities of the query, and does not restrict them
+    ecs.systems.execute([](Time* t, const B*) { t->frame++; });
+    NEAT_TEST_ASSERT(time->frame == 5);
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<const Time, B>()) == 5);
+
+    // Systems writing the singleton conflict with systems reading it
+    ecs.scheduler.add(test_singleton_apply_time);
+    ecs.scheduler.add([](const Time*, B*) {});
+    ecs.scheduler.add([](Time* t) { t->delta = 0; });
+    NEAT_TEST_ASSERT(ecs.scheduler.schedule().size() == 2);
+    NEAT_TEST_ASSERT(ecs.scheduler.schedule()[0].size() == 2);
+
+    ecs.entities.remove(0);
+    NEAT_TEST_ASSERT(ecs.components.get<Time>() == time);
+    NEAT_TEST_ASSERT(ecs.components.remove<Time>());
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<Time, A>()) == 0);
+
+    // The new value may be built from the current one
+    neat::ecs::engine<A, Motd> motd;
+    motd.components.set<Motd>(std::string(100, 'x'));
+    motd.components.set<Motd>(*motd.components.get<Motd>());
+    NEAT_TEST_ASSERT(motd.components.get<Motd>()->text == std::string(100, 'x'));
+    motd.components.set<Motd>(motd.components.get<Motd>()->text + "y");
+    NEAT_TEST_ASSERT(motd.components.get<Motd>()->text.size() == 101);
+}
+
+void test_scheduler_write_a(A* a) {
+    a->a += 1;
+}
+
+void test_scheduler_copy_a_to_b(const A* a, B* b) {
+    b->b = a->a;
+}
+
+void test_scheduler_read_c(neat::ecs::entity_id, const C*) {}
+
+void test_scheduler_write_c(C* c) {
+    c->c += 1;
+}
+
+void test_scheduler_read_a(const A*) {}
+
+void test_scheduler_exclusive(ecs& ecs, const A*) {
+    (void)ecs;
+}
+
+void test_scheduler() {
+    ecs                    ecs;
+    neat::ecs::thread_pool pool(4);
+
+    for (int i = 0; i < 1000; i++) {
+        auto e = ecs.entities.create();
+        ecs.components.add<A>(e, i);
+        ecs.components.add<B>(e);
+        ecs.components.add<C>(e);
+    }
+
+    NEAT_TEST_ASSERT(ecs.scheduler.add(test_scheduler_write_a) == 0);
+    NEAT_TEST_ASSERT(ecs.scheduler.add(test_scheduler_copy_a_to_b) == 1);
+    NEAT_TEST_ASSERT(ecs.scheduler.add(test_scheduler_read_c) == 2);
+    NEAT_TEST_ASSERT(ecs.scheduler.add(test_scheduler_write_c) == 3);
+    NEAT_TEST_ASSERT(ecs.scheduler.add(test_scheduler_read_a) == 4);
+    NEAT_TEST_ASSERT(ecs.scheduler.add(test_scheduler_exclusive) == 5);
+
+    std::vector<std::vector<std::size_t>> expected = {{0, 2}, {1, 3, 4}, {5}};
+    NEAT_TEST_ASSERT(ecs.scheduler.schedule() == expected);
+
+    ecs.scheduler.run(pool);
+    ecs.scheduler.run(pool);
+
+    bool all_correct = true;
+    for (auto [a, b, c] : ecs.iterate_components<const A, B, C>()) {
+        all_correct &= b->b == a->a && c->c == 2;
+    }
+    NEAT_TEST_ASSERT(all_correct);
+}
+
+void test_cached_query() {
+    ecs ecs;
+
+    auto e1 = ecs.entities.create();
+    auto e2 = ecs.entities.create();
+    auto e3 = ecs.entities.create();
+    ecs.components.add<A>(e1, 1);
+    ecs.components.add<B>(e1, 1);
+    ecs.components.add<A>(e2, 2);
+
+    auto query = ecs.cache<A, B>();
+    NEAT_TEST_ASSERT(query.size() == 1);
+    NEAT_TEST_ASSERT(query.entities()[0] == e1);
+
+    ecs.components.add<B>(e2, 2);
+    ecs.components.add<B>(e3, 3);
+    NEAT_TEST_ASSERT(query.size() == 2);
+    for (auto [entity, a, b] : query) {
+        NEAT_TEST_ASSERT(entity == e1 || entity == e2);
+        NEAT_TEST_ASSERT(a->a == b->b);
+    }
+
+    ecs.components.remove<A>(e1);
+    NEAT_TEST_ASSERT(query.size() == 1);
+    ecs.entities.remove(e2);
+    NEAT_TEST_ASSERT(query.empty());
+
+    {
+        auto all = ecs.cache<>();
+        NEAT_TEST_ASSERT(all.size() == 2);
+        ecs.entities.create();
+        NEAT_TEST_ASSERT(all.size() == 3);
+    }
+
+    ecs.components.add<A>(e3);
+    NEAT_TEST_ASSERT(query.size() == 1);
+    NEAT_TEST_ASSERT(std::get<0>(query.front()) == e3);
+}
+
+void test_bulk_entities() {
+    ecs ecs;
+
+    std::vector<neat::ecs::entity_id> first = ecs.entities.create_many(1000);
+    NEAT_TEST_ASSERT(first.size() == 1000);
+    NEAT_TEST_ASSERT(first.front() == 0 && first.back() == 999);
+    NEAT_TEST_ASSERT(ecs.components.add_many<A>(first, 5) == 1000);
+    NEAT_TEST_ASSERT(ecs.components.get<A>(first[500])->a == 5);
+
+    std::vector<neat::ecs::entity_id> removed = {10, 20, 20, 30, 5000};
+    NEAT_TEST_ASSERT(ecs.entities.remove_many(removed) == 3);
+    NEAT_TEST_ASSERT(!ecs.entities.exists(20));
+    NEAT_TEST_ASSERT(!ecs.components.has<A>(20));
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<A>()) == 997);
+
+    // Freed ids are reused before new ids are allocated
+    std::vector<neat::ecs::entity_id> second   = ecs.entities.create_many(5);
+    std::vector<neat::ecs::entity_id> expected = {10, 20, 30, 1000, 1001};
+    NEAT_TEST_ASSERT(second == expected);
+    NEAT_TEST_ASSERT(ecs.components.add_many<B>(second, 7) == 5);
+    NEAT_TEST_ASSERT(!ecs.components.has<A>(10));
+    NEAT_TEST_ASSERT(ecs.components.get<B>(1001)->b == 7);
+    NEAT_TEST_ASSERT(ecs.entities.all().size() == 1002);
+
+    // Repeated batches grow the component list geometrically
+    for (int batch = 0; batch < 500; batch++) {
+        ecs.components.add_many<C>(ecs.entities.create_many(4), batch);
+    }
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<C>()) == 2000);
+    NEAT_TEST_ASSERT(ecs.components.get<C>(3001)->c == 499);
+    if constexpr (neat::ecs::profiling)
+        NEAT_TEST_ASSERT(ecs.profile().components[2].counters.resizes < 20);
+}
+
+void test_component_lifetimes() {
+    {
+        neat::ecs::engine<Tracked, TrackedRare> ecs;
+
+        std::vector<neat::ecs::entity_id> entities = ecs.entities.create_many(1000);
+        for (neat::ecs::entity_id entity : entities) {
+            ecs.components.add<Tracked>(entity, std::to_string(entity));
+            if (entity % 4 == 0)
+                ecs.components.add<TrackedRare>(entity, std::to_string(entity));
+        }
+        NEAT_TEST_ASSERT(Tracked::alive == 1250);
+        NEAT_TEST_ASSERT(ecs.components.get<Tracked>(999)->name == "999");
+
+        // Replacing a component destroys the previous one
+        ecs.components.add<Tracked>(10, "ten");
+        NEAT_TEST_ASSERT(Tracked::alive == 1250);
+        NEAT_TEST_ASSERT(ecs.components.get<Tracked>(10)->name == "ten");
+
+        for (neat::ecs::entity_id entity = 0; entity < 1000; entity += 2) {
+            ecs.components.remove<Tracked>(entity);
+        }
+        ecs.components.remove<TrackedRare>(0);
+        NEAT_TEST_ASSERT(Tracked::alive == 749);
+        NEAT_TEST_ASSERT(ecs.components.get<TrackedRare>(996)->name == "996");
+
+        ecs.entities.remove(4);
+        NEAT_TEST_ASSERT(Tracked::alive == 748);
+
+        // Arguments may refer to the replaced component, or to components which are moved when the list grows
+        ecs.components.add<Tracked>(11, ecs.components.get<Tracked>(11)->name);
+        ecs.components.add<TrackedRare>(8, ecs.components.get<TrackedRare>(8)->name);
+        NEAT_TEST_ASSERT(ecs.components.get<Tracked>(11)->name == "11");
+        NEAT_TEST_ASSERT(ecs.components.get<TrackedRare>(8)->name == "8");
+        std::vector<neat::ecs::entity_id> created = ecs.entities.create_many(2000);
+        for (neat::ecs::entity_id entity : created) {
+            ecs.components.add<Tracked>(entity, ecs.components.get<Tracked>(11)->name);
+            ecs.components.add<TrackedRare>(entity, ecs.components.get<TrackedRare>(8)->name);
+        }
+        NEAT_TEST_ASSERT(ecs.components.get<Tracked>(created.back())->name == "11");
+        NEAT_TEST_ASSERT(ecs.components.get<TrackedRare>(created.back())->name == "8");
+        NEAT_TEST_ASSERT(Tracked::alive == 4748);
+    }
+    NEAT_TEST_ASSERT(Tracked::alive == 0);
+
+    // Components are replaced and moved without assigning them
+    neat::ecs::engine<Fixed, FixedRare> fixed;
+    for (neat::ecs::entity_id entity : fixed.entities.create_many(10)) {
+        fixed.components.add<Fixed>(entity, static_cast<int>(entity));
+        fixed.components.add<FixedRare>(entity, static_cast<int>(entity));
+    }
+    fixed.components.add<Fixed>(3, 30);
+    fixed.components.add<FixedRare>(3, fixed.components.get<FixedRare>(3)->id * 10);
+    fixed.components.remove<FixedRare>(0);
+    NEAT_TEST_ASSERT(fixed.components.get<Fixed>(3)->id == 30);
+    NEAT_TEST_ASSERT(fixed.components.get<FixedRare>(3)->id == 30);
+    NEAT_TEST_ASSERT(fixed.components.get<FixedRare>(9)->id == 9);
+    NEAT_TEST_ASSERT(std::ranges::distance(fixed.iterate<Fixed, FixedRare>()) == 9);
+}
+
+void test_change_detection_move(Moved* moved, A* a) {
+    moved->x += a->a;
+}
+
+void test_change_detection_read(const Moved* moved, B* b) {
+    b->b = moved->x;
+}
+
+void test_change_detection() {
+    neat::ecs::engine<A, B, Moved, Spotted> ecs;
+
+    std::vector<neat::ecs::entity_id> entities = ecs.entities.create_many(100);
+    ecs.components.add_many<Moved>(entities);
+    ecs.components.add_many<B>(entities);
+    for (neat::ecs::entity_id entity = 0; entity < 100; entity += 10) {
+        ecs.components.add<A>(entity, 1);
+        ecs.components.add<Spotted>(entity);
+    }
+
+    auto collect = [](auto view) {
+        std::vector<neat::ecs::entity_id> found;
+        for (auto data : view) {
+            found.push_back(std::get<0>(data));
+        }
+        std::sort(found.begin(), found.end());
+        return found;
+    };
+
+    neat::ecs::tick_type since = ecs.current_tick();
+    NEAT_TEST_ASSERT(ecs.advance_tick() == since + 1);
+    NEAT_TEST_ASSERT(collect(ecs.iterate<neat::ecs::changed<Moved>>(since)).empty());
+    NEAT_TEST_ASSERT(collect(ecs.iterate<neat::ecs::changed<Moved>>()).size() == 100);
+
+    // Systems mark the components they receive as non-const pointers as changed
+    ecs.systems.execute(test_change_detection_move);
+    ecs.systems.execute(test_change_detection_read);
+    ecs.components.get<Moved>(5);
+    ecs.components.get<const Moved>(6);
+    ecs.components.get<Spotted>(20)->by = 1;
+
+    std::vector<neat::ecs::entity_id> expected = {0, 5, 10, 20, 30, 40, 50, 60, 70, 80, 90};
+    NEAT_TEST_ASSERT(collect(ecs.iterate<Moved, neat::ecs::changed<Moved>>(since)) == expected);
+    NEAT_TEST_ASSERT(collect(ecs.iterate<neat::ecs::changed<Spotted>>(since)).size() == 1);
+    NEAT_TEST_ASSERT(collect(ecs.iterate<neat::ecs::changed<Moved, Spotted>>(since)).size() == 1);
+
+    // Added components are also changed, removing and adding a component again resets its ticks
+    since = ecs.current_tick();
+    ecs.advance_tick();
+    ecs.components.remove<Spotted>(10);
+    ecs.components.add<Spotted>(10);
+    ecs.components.add<Moved>(ecs.entities.create());
+    expected = {10};
+    NEAT_TEST_ASSERT(collect(ecs.iterate<neat::ecs::added<Spotted>>(since)) == expected);
+    NEAT_TEST_ASSERT(collect(ecs.iterate<neat::ecs::changed<Spotted>>(since)) == expected);
+    expected = {100};
+    NEAT_TEST_ASSERT(collect(ecs.iterate<neat::ecs::added<Moved>>(since)) == expected);
+    NEAT_TEST_ASSERT(collect(ecs.iterate<neat::ecs::changed<Moved>>(since)) == expected);
+}
+
+void test_command_buffer() {
+    ecs                 ecs;
+    ecs::command_buffer buffer;
+
+    for (int i = 0; i < 100; i++) {
+        ecs.components.add<A>(ecs.entities.create(), i);
+    }
+
+    // Structural changes while iterating are deferred until the flush
+    for (auto [entity, a] : ecs.iterate<A>()) {
+        if (a->a % 2 == 0) {
+            buffer.remove(entity);
+        } else {
+            auto child = buffer.create();
+            buffer.add<B>(child, a->a);
+            buffer.add<C>(entity, a->a);
+            buffer.remove<A>(entity);
+        }
+    }
+    NEAT_TEST_ASSERT(!buffer.empty());
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<A>()) == 100);
+
+    ecs.flush(buffer);
+    NEAT_TEST_ASSERT(buffer.empty());
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<A>()) == 0);
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<B>()) == 50);
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<C>()) == 50);
+    NEAT_TEST_ASSERT(ecs.entities.all().size() == 100);
+
+    // Buffers recorded on different threads are merged before flushing
+    neat::ecs::thread_pool           pool(4);
+    std::vector<ecs::command_buffer> buffers(pool.thread_count());
+    pool.parallel_for(0, 1000, 10, [&buffers, &pool](std::size_t first, std::size_t last) {
+        ecs::command_buffer& local = buffers[pool.thread_index()];
+        for (std::size_t index = first; index < last; index++) {
+            local.add<A>(local.create(), static_cast<int>(index));
+        }
+    });
+    for (ecs::command_buffer& local : buffers) {
+        buffer.merge(std::move(local));
+    }
+    ecs.flush(buffer);
+
+    std::vector<int> values;
+    for (auto [a] : ecs.iterate_components<A>()) {
+        values.push_back(a->a);
+    }
+    std::sort(values.begin(), values.end());
+    NEAT_TEST_ASSERT(values.size() == 1000);
+    NEAT_TEST_ASSERT(values.front() == 0 && values.back() == 999);
+    NEAT_TEST_ASSERT(std::adjacent_find(values.begin(), values.end()) == values.end());
+
+    // Provisional ids of another buffer, or of an earlier flush, are skipped
+    ecs::command_buffer other;
+    auto                foreign = other.create();
+    auto                stale   = buffer.create();
+    ecs.flush(buffer);
+    std::size_t entity_count = ecs.entities.all().size();
+    buffer.add<A>(foreign, 5);
+    buffer.add<B>(stale, 6);
+    buffer.remove(foreign);
+    buffer.remove<A>(stale);
+    ecs.flush(buffer);
+    NEAT_TEST_ASSERT(ecs.entities.all().size() == entity_count);
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<A>()) == 1000);
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<B>()) == 50);
+
+    // Flushing every frame grows the component lists geometrically
+    ecs::command_buffer frame;
+    for (int i = 0; i < 2000; i++) {
+        frame.add<C>(frame.create(), i);
+        ecs.flush(frame);
+    }
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<C>()) == 2050);
+    if constexpr (neat::ecs::profiling)
+        NEAT_TEST_ASSERT(ecs.profile().components[2].counters.resizes < 20);
+}
+
+// Memory resource counting the bytes that are currently allocated through it
+struct counting_resource : std::pmr::memory_resource {
+    std::size_t allocations = 0;
+    std::size_t outstanding = 0;
+
+    void* do_allocate(std::size_t size, std::size_t alignment) override {
+        allocations++;
+        outstanding += size;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+    void do_deallocate(void* ptr, std::size_t size, std::size_t alignment) override {
+        outstanding -= size;
+        std::pmr::new_delete_resource()->deallocate(ptr, size, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+struct Enemy {};
+struct Visible {};
+
+void test_tag_components() {
+    static_assert(neat::ecs::typing::is_tag<Enemy>);
+
+    counting_resource                    resource;
+    neat::ecs::engine<A, Enemy, Visible> ecs(&resource);
+    ecs.entities.create_many(100000);
+    std::size_t before = resource.outstanding;
+    for (neat::ecs::entity_id entity = 0; entity < 100000; entity++) {
+        if (entity % 3 == 0)
+            ecs.components.add<Enemy>(entity);
+        if (entity % 2 == 0)
+            ecs.components.add<Visible>(entity);
+    }
+
+    // Only a bit per entity is stored, and all entities share the same empty object
+    NEAT_TEST_ASSERT(resource.outstanding - before < 2 * 2 * 100000 / 8 + 4096);
+    for (neat::ecs::entity_id entity = 0; entity < 100000; entity += 1001) {
+        ecs.components.add<A>(entity, static_cast<int>(entity));
+    }
+    NEAT_TEST_ASSERT(ecs.components.get<Enemy>(3) == ecs.components.get<Enemy>(6));
+    NEAT_TEST_ASSERT(ecs.components.get<Enemy>(4) == nullptr);
+
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<Enemy, Visible>()) == 16667);
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<A, neat::ecs::with<Enemy>, neat::ecs::without<Visible>>()) == 17);
+
+    ecs.components.remove<Enemy>(3);
+    ecs.entities.remove(6);
+    NEAT_TEST_ASSERT(!ecs.components.has<Enemy>(3) && !ecs.components.has<Visible>(6));
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<Enemy, Visible>()) == 16666);
+    NEAT_TEST_ASSERT(std::get<0>(ecs.components.first<Enemy>()) == 0);
+}
+
+struct Body {
+    float       x  = 0;
+    float       y  = 0;
+    float       vx = 0;
+    float       vy = 0;
+    std::string name;
+};
+
+template <>
+struct neat::ecs::component_traits<Body> {
+    using storage                = neat::ecs::soa_storage;
+    static constexpr auto fields = std::tuple {&Body::x, &Body::y, &Body::vx, &Body::vy, &Body::name};
+};
+
+void test_soa_storage() {
+    neat::ecs::engine<A, Body> ecs;
+
+    for (int i = 0; i < 100; i++) {
+        auto entity = ecs.entities.create();
+        if (i % 2 == 0)
+            ecs.components.add<Body>(entity, float(i), 0.0f, 1.0f, 2.0f, "body");
+        if (i % 4 == 0)
+            ecs.components.add<A>(entity, i);
+    }
+
+    // Single components are accessed through a handle to their fields
+    auto body = ecs.components.get<Body>(10);
+    NEAT_TEST_ASSERT(body != nullptr);
+    NEAT_TEST_ASSERT(body.get<&Body::x>() == 10.0f);
+    NEAT_TEST_ASSERT(body.get<&Body::name>() == "body");
+    NEAT_TEST_ASSERT(ecs.components.get<Body>(11) == nullptr);
+    body.get<&Body::y>() = 5.0f;
+    NEAT_TEST_ASSERT(body.load().y == 5.0f);
+    neat::ecs::soa_pointer<const Body> read = ecs.components.get<const Body>(10);
+    NEAT_TEST_ASSERT(read.get<&Body::vy>() == 2.0f);
+
+    // Kernels run over the plain field arrays, which are indexed by entity id
+    auto [x, y, vx, vy, name] = ecs.components.fields<Body>();
+    NEAT_TEST_ASSERT(x.size() >= 99);
+    for (std::size_t entity = 0; entity < x.size(); entity++) {
+        x[entity] += vx[entity];
+        y[entity] += vy[entity];
+    }
+    NEAT_TEST_ASSERT(ecs.components.get<Body>(10).get<&Body::x>() == 11.0f);
+    NEAT_TEST_ASSERT(ecs.components.get<Body>(10).get<&Body::y>() == 7.0f);
+
+    // Removed components leave value-initialized fields behind
+    ecs.components.remove<Body>(8);
+    ecs.entities.remove(12);
+    NEAT_TEST_ASSERT(!ecs.components.has<Body>(8));
+    NEAT_TEST_ASSERT(x[8] == 0.0f && name[8].empty() && name[12].empty());
+
+    // Struct-of-arrays components can still be used as a filter
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<A, neat::ecs::with<Body>>()) == 23);
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<A, neat::ecs::without<Body>>()) == 1);
+}
+
+void test_memory_resource() {
+    counting_resource resource;
+    {
+        neat::ecs::engine<A, Rare, Tracked, TrackedRare> ecs(&resource);
+        NEAT_TEST_ASSERT(resource.allocations > 0);  // Component bitsets are sized upfront
+
+        std::size_t before = resource.allocations;
+        for (int i = 0; i < 1000; i++) {
+            auto entity = ecs.entities.create();
+            ecs.components.add<A>(entity, i);
+            ecs.components.add<Tracked>(entity, "dense");
+            if (i % 10 == 0) {
+                ecs.components.add<Rare>(entity, i);
+                ecs.components.add<TrackedRare>(entity, "sparse");
+            }
+        }
+        ecs.entities.remove(0);
+        NEAT_TEST_ASSERT(resource.allocations > before);
+        NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<A, Rare>()) == 99);
+    }
+    NEAT_TEST_ASSERT(resource.outstanding == 0);
+    NEAT_TEST_ASSERT(Tracked::alive == 0);
+
+    // A bump allocator never frees, the whole engine is released at once
+    neat::allocators::bump          bump(1 << 16);
+    neat::allocators::bump_resource bump_resource(bump);
+    {
+        neat::ecs::engine<A, Rare> ecs(&bump_resource);
+        for (int i = 0; i < 1000; i++) {
+            ecs.components.add<A>(ecs.entities.create(), i);
+        }
+        NEAT_TEST_ASSERT(ecs.components.get<A>(999)->a == 999);
+    }
+    NEAT_TEST_ASSERT(bump.block_count() > 0);
+}
+
+void test_compact() {
+    neat::ecs::engine<A, Rare, Tracked, Body, Enemy> ecs;
+    ecs.entities.create_many(10);
+    ecs.entities.remove(7);
+    ecs.entities.remove(2);
+    ecs.entities.remove(5);
+
+    // Removed ids are handed out again following the reuse policy
+    NEAT_TEST_ASSERT(ecs.entities.policy() == neat::ecs::reuse_policy::fifo);
+    ecs.entities.set_reuse_policy(neat::ecs::reuse_policy::lowest_first);
+    NEAT_TEST_ASSERT(ecs.entities.create() == 2);
+    ecs.entities.remove(9);
+    ecs.entities.set_reuse_policy(neat::ecs::reuse_policy::lifo);
+    NEAT_TEST_ASSERT(ecs.entities.create() == 9);
+    ecs.entities.remove(9);
+
+    ecs.entities.create_many(93);
+    for (neat::ecs::entity_id entity = 0; entity < 100; entity++) {
+        ecs.components.add<A>(entity, static_cast<int>(entity));
+        ecs.components.add<Tracked>(entity, std::to_string(entity));
+        ecs.components.add<Body>(entity, float(entity), 0.0f, 0.0f, 0.0f, "body");
+        if (entity % 10 == 0) {
+            ecs.components.add<Rare>(entity, static_cast<int>(entity));
+            ecs.components.add<Enemy>(entity);
+        }
+    }
+    auto query = ecs.cache<A, Rare>();
+    for (neat::ecs::entity_id entity = 0; entity < 100; entity += 3) {
+        ecs.entities.remove(entity);
+    }
+    NEAT_TEST_ASSERT(query.size() == 6);
+
+    // Live entities are renumbered densely, keeping their order and components
+    std::vector<neat::ecs::entity_id> remap = ecs.entities.compact();
+    NEAT_TEST_ASSERT(remap.size() >= 100);
+    NEAT_TEST_ASSERT(remap[0] == neat::ecs::invalid_entity && remap[1] == 0 && remap[2] == 1 && remap[4] == 2);
+    NEAT_TEST_ASSERT(ecs.entities.all().size() == 66);
+    NEAT_TEST_ASSERT(ecs.entities.last() == 65);
+    NEAT_TEST_ASSERT(ecs.components.get<A>(remap[50])->a == 50);
+    NEAT_TEST_ASSERT(ecs.components.get<Tracked>(remap[98])->name == "98");
+    NEAT_TEST_ASSERT(ecs.components.get<Body>(remap[97]).get<&Body::x>() == 97.0f);
+    NEAT_TEST_ASSERT(ecs.components.get<Rare>(remap[40])->rare == 40);
+    NEAT_TEST_ASSERT(ecs.components.has<Enemy>(remap[80]) && !ecs.components.has<Enemy>(remap[79]));
+    NEAT_TEST_ASSERT(std::get<0>(ecs.components.fields<Body>()).size() == 66);
+    NEAT_TEST_ASSERT(Tracked::alive == 66);
+
+    NEAT_TEST_ASSERT(query.size() == 6);
+    for (auto [entity, a, rare] : query) {
+        NEAT_TEST_ASSERT(remap[static_cast<std::size_t>(a->a)] == entity && rare->rare == a->a);
+    }
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<A, Enemy>()) == 6);
+    NEAT_TEST_ASSERT(ecs.entities.create() == 66);
+}
+
+struct Point {
+    float x = 0;
+    float y = 0;
+};
+
+template <>
+struct neat::ecs::component_traits<Point> {
+    using storage                = neat::ecs::soa_storage;
+    static constexpr auto fields = std::tuple {&Point::x, &Point::y};
+};
+
+using snapshot_ecs = neat::ecs::engine<A, Rare, Name, Moved, Point, Enemy, Time>;
+
+void test_snapshot() {
+    snapshot_ecs ecs;
+    ecs.entities.create_many(1000);
+    for (neat::ecs::entity_id entity = 0; entity < 1000; entity++) {
+        int value = static_cast<int>(entity);
+        ecs.components.add<A>(entity, value);
+        if (entity % 10 == 0)
+            ecs.components.add<Rare>(entity, value);
+        if (entity % 7 == 0)
+            ecs.components.add<Name>(entity, std::to_string(entity));
+        if (entity % 3 == 0)
+            ecs.components.add<Moved>(entity, value);
+        if (entity % 2 == 0)
+            ecs.components.add<Point>(entity, float(entity), -float(entity));
+        if (entity % 5 == 0)
+            ecs.components.add<Enemy>(entity);
+        if (ecs.current_tick() < 3)
+            ecs.advance_tick();
+    }
+    for (neat::ecs::entity_id entity = 0; entity < 1000; entity += 11) {
+        ecs.entities.remove(entity);
+    }
+    ecs.components.set<Time>(16, 3);
+    ecs.advance_tick();
+
+    std::stringstream stream;
+    ecs.save(stream);
+
+    // Restoring replaces the whole state, and cached queries follow it
+    snapshot_ecs copy;
+    auto         query = copy.cache<A, Rare>();
+    copy.components.add<A>(copy.entities.create(), -1);
+    NEAT_TEST_ASSERT(copy.restore(stream));
+    NEAT_TEST_ASSERT(copy.entities.all() == ecs.entities.all());
+    NEAT_TEST_ASSERT(copy.current_tick() == ecs.current_tick());
+    NEAT_TEST_ASSERT(query.size() == static_cast<std::size_t>(std::ranges::distance(ecs.iterate<A, Rare>())));
+    for (auto [entity, a] : ecs.iterate<A>()) {
+        NEAT_TEST_ASSERT(copy.components.get<A>(entity)->a == a->a);
+        NEAT_TEST_ASSERT(copy.components.has<Rare>(entity) == ecs.components.has<Rare>(entity));
+        NEAT_TEST_ASSERT(copy.components.has<Enemy>(entity) == ecs.components.has<Enemy>(entity));
+        NEAT_TEST_ASSERT(copy.components.has<Name>(entity) == ecs.components.has<Name>(entity));
+        if (ecs.components.has<Name>(entity))
+            NEAT_TEST_ASSERT(copy.components.get<Name>(entity)->name == ecs.components.get<Name>(entity)->name);
+        if (ecs.components.has<Point>(entity))
+            NEAT_TEST_ASSERT(copy.components.get<Point>(entity).get<&Point::y>() == -float(entity));
+    }
+    NEAT_TEST_ASSERT(copy.components.get<Time>()->frame == 3);
+    NEAT_TEST_ASSERT(std::ranges::distance(copy.iterate<neat::ecs::changed<Moved>>(3)) == std::ranges::distance(ecs.iterate<neat::ecs::changed<Moved>>(3)));
+    NEAT_TEST_ASSERT(copy.entities.create() == ecs.entities.create());
+
+    // A snapshot can be restored from memory, such as a mapped file
+    std::string bytes = stream.str();
+    snapshot_ecs mapped;
+    NEAT_TEST_ASSERT(mapped.restore(std::as_bytes(std::span(bytes))));
+    NEAT_TEST_ASSERT(mapped.components.get<Rare>(980)->rare == 980);
+
+    // Snapshots of other engines are rejected without changes, corrupt snapshots leave an empty engine
+    neat::ecs::engine<A, Rare> other;
+    other.components.add<A>(other.entities.create(), 5);
+    NEAT_TEST_ASSERT(!other.restore(std::as_bytes(std::span(bytes))));
+    NEAT_TEST_ASSERT(other.components.get<A>(0)->a == 5);
+
+    // Component types of the same size and storage are told apart by their names
+    std::stringstream pair;
+    neat::ecs::engine<A, B>{}.save(pair);
+    std::string             pair_bytes = pair.str();
+    neat::ecs::engine<B, A> swapped;
+    neat::ecs::engine<A, C> renamed;
+    neat::ecs::engine<A, B> same;
+    NEAT_TEST_ASSERT(!swapped.restore(std::as_bytes(std::span(pair_bytes))));
+    NEAT_TEST_ASSERT(!renamed.restore(std::as_bytes(std::span(pair_bytes))));
+    NEAT_TEST_ASSERT(same.restore(std::as_bytes(std::span(pair_bytes))));
+    NEAT_TEST_ASSERT(!mapped.restore(std::as_bytes(std::span(bytes)).first(bytes.size() / 2)));
+    NEAT_TEST_ASSERT(mapped.entities.all().empty());
+    NEAT_TEST_ASSERT(mapped.components.get<Time>() == nullptr);
+}
+
+// Compares the entities and components of two engines, packed sparse components may be ordered differently
+bool same_state(snapshot_ecs& left, snapshot_ecs& right) {
+    if (left.entities.all() != right.entities.all() || left.current_tick() != right.current_tick())
+        return false;
+    for (neat::ecs::entity_id entity : left.entities.all()) {
+        auto same = [&]<typename Component>(auto&& equal) {
+            auto* l = left.components.get<Component>(entity);
+            auto* r = right.components.get<Component>(entity);
+            return (l == nullptr) == (r == nullptr) && (l == nullptr || equal(*l, *r));
+        };
+        bool equal = same.template operator()<A>([](const A& l, const A& r) { return l.a == r.a; })
+                  && same.template operator()<Rare>([](const Rare& l, const Rare& r) { return l.rare == r.rare; })
+                  && same.template operator()<Name>([](const Name& l, const Name& r) { return l.name == r.name; })
+                  && same.template operator()<Moved>([](const Moved& l, const Moved& r) { return l.x == r.x; })
+                  && left.components.has<Enemy>(entity) == right.components.has<Enemy>(entity)
+                  && left.components.has<Point>(entity) == right.components.has<Point>(entity);
+        if (!equal)
+            return false;
+        if (left.components.has<Point>(entity) && left.components.get<Point>(entity).get<&Point::x>() != right.components.get<Point>(entity).get<&Point::x>())
+            return false;
+    }
+    auto* time = left.components.get<Time>();
+    return (time == nullptr) == (right.components.get<Time>() == nullptr) && (time == nullptr || time->frame == right.components.get<Time>()->frame);
+}
+
+void test_delta() {
+    snapshot_ecs ecs;
+    for (int i = 0; i < 500; i++) {
+        auto entity = ecs.entities.create();
+        ecs.components.add<A>(entity, i);
+        ecs.components.add<Point>(entity, float(i), 0.0f);
+        if (i % 10 == 0)
+            ecs.components.add<Rare>(entity, i);
+        if (i % 4 == 0)
+            ecs.components.add<Moved>(entity, i);
+    }
+    std::stringstream snapshot;
+    ecs.save(snapshot);
+    std::string base = snapshot.str();
+
+    snapshot_ecs replica;
+    NEAT_TEST_ASSERT(replica.restore(snapshot));
+    auto query = replica.cache<A, Rare>();
+
+    // Only the changes are sent, and applying them reproduces the state
+    ecs.advance_tick();
+    for (neat::ecs::entity_id entity = 0; entity < 500; entity += 50) {
+        ecs.entities.remove(entity);
+    }
+    for (neat::ecs::entity_id entity = 1; entity < 500; entity += 25) {
+        ecs.components.get<A>(entity)->a = -1;
+        ecs.components.add<Rare>(entity, 7);
+        ecs.components.add<Name>(entity, "changed");
+        ecs.components.add<Enemy>(entity);
+        ecs.components.remove<Point>(entity);
+    }
+    ecs.components.remove<Rare>(10);
+    for (neat::ecs::entity_id entity = 4; entity < 500; entity += 100) {
+        ecs.components.get<Moved>(entity)->x++;
+    }
+    ecs.entities.create_many(20);
+    ecs.components.set<Time>(1, 2);
+
+    std::stringstream delta;
+    NEAT_TEST_ASSERT(ecs.delta(std::as_bytes(std::span(base)), delta));
+    NEAT_TEST_ASSERT(delta.str().size() < base.size() / 4);
+    NEAT_TEST_ASSERT(replica.apply(delta));
+    NEAT_TEST_ASSERT(same_state(ecs, replica));
+    NEAT_TEST_ASSERT(query.size() == static_cast<std::size_t>(std::ranges::distance(ecs.iterate<A, Rare>())));
+    NEAT_TEST_ASSERT(replica.entities.create() == ecs.entities.create());
+
+    // Deltas can be taken against any engine in the base state, and must be applied in order
+    snapshot_ecs previous;
+    std::stringstream current;
+    ecs.save(current);
+    previous.restore(current);
+    ecs.components.remove<Time>();
+    ecs.entities.remove(3);
+    std::stringstream next;
+    ecs.delta(previous, next);
+    std::string next_bytes = next.str();
+    NEAT_TEST_ASSERT(replica.apply(std::as_bytes(std::span(next_bytes))));
+    NEAT_TEST_ASSERT(same_state(ecs, replica));
+    NEAT_TEST_ASSERT(!replica.apply(std::as_bytes(std::span(next_bytes))));
+    NEAT_TEST_ASSERT(replica.entities.exists(5));
+}
+
+void profiled_system(A* a) {
+    a->a++;
+}
+
+void test_profile() {
+    snapshot_ecs ecs;
+    for (int i = 0; i < 100; i++) {
+        auto entity = ecs.entities.create();
+        ecs.components.add<A>(entity, i);
+        if (i % 10 == 0)
+            ecs.components.add<Rare>(entity, i);
+    }
+    auto lambda = [](const A* a, Rare* rare) { rare->rare = a->a; };
+    ecs.systems.name(lambda, "copy rare");
+    ecs.systems.execute(profiled_system);
+    ecs.systems.execute(profiled_system);
+    ecs.systems.execute(lambda);
+
+    // Without NEAT_ECS_PROFILE the report is empty, and the engine behaves the same
+    neat::ecs::profile_report report = ecs.profile();
+    if constexpr (neat::ecs::profiling) {
+        // Systems are listed in the order they were first named or executed
+        NEAT_TEST_ASSERT(report.systems.size() == 2);
+        NEAT_TEST_ASSERT(report.systems[0].name == "copy rare");
+        NEAT_TEST_ASSERT(report.systems[0].runs == 1);
+        NEAT_TEST_ASSERT(report.systems[0].entities == 10);
+        NEAT_TEST_ASSERT(report.systems[1].runs == 2);
+        NEAT_TEST_ASSERT(report.systems[1].entities == 200);
+        NEAT_TEST_ASSERT(report.components.size() == 7);
+        NEAT_TEST_ASSERT(report.components[0].count == 100);
+        NEAT_TEST_ASSERT(report.components[0].counters.adds == 100);
+        NEAT_TEST_ASSERT(report.components[0].counters.reserved_bytes >= 100 * sizeof(A));
+        NEAT_TEST_ASSERT(report.components[0].name.find('A') != std::string::npos);
+
+        std::stringstream trace;
+        ecs.write_trace(trace);
+        NEAT_TEST_ASSERT(trace.str().find("\"copy rare\"") != std::string::npos);
+        NEAT_TEST_ASSERT(trace.str().find("\"ph\":\"C\"") != std::string::npos);
+
+        ecs.reset_profile();
+        ecs.systems.execute(lambda);
+        report = ecs.profile();
+        NEAT_TEST_ASSERT(report.systems[0].runs == 1);
+        NEAT_TEST_ASSERT(report.systems[0].name == "copy rare");
+        NEAT_TEST_ASSERT(report.systems[1].runs == 0);
+    } else {
+        NEAT_TEST_ASSERT(report.systems.empty() && report.components.empty());
+    }
+    NEAT_TEST_ASSERT(ecs.components.get<A>(0)->a == 2);
+    NEAT_TEST_ASSERT(ecs.components.get<Rare>(10)->rare == 12);
+}
+
+void test_memory_stats() {
+    snapshot_ecs ecs;
+    for (int i = 0; i < 1000; i++) {
+        auto entity = ecs.entities.create();
+        ecs.components.add<A>(entity, i);
+        ecs.components.add<Point>(entity, float(i), 0.0f);
+        ecs.components.add<Enemy>(entity);
+        if (i % 10 == 0)
+            ecs.components.add<Rare>(entity, i);
+    }
+    for (neat::ecs::entity_id entity = 100; entity < 1000; entity++) {
+        ecs.entities.remove(entity);
+    }
+
+    neat::ecs::memory_report before = ecs.memory_stats();
+    NEAT_TEST_ASSERT(before.entities == 100);
+    NEAT_TEST_ASSERT(before.entity_capacity == 1000);
+    NEAT_TEST_ASSERT(before.free_entities == 900);
+    NEAT_TEST_ASSERT(before.components.size() == 7);
+    NEAT_TEST_ASSERT(before.components[0].count == 100);
+    NEAT_TEST_ASSERT(before.components[0].capacity >= 1000);
+    NEAT_TEST_ASSERT(before.components[0].occupancy <= 0.1);
+    NEAT_TEST_ASSERT(before.components[0].bytes >= 1000 * sizeof(A));
+
+    // Trailing slots without a component are released, and the remaining components are kept
+    ecs.shrink_to_fit();
+    neat::ecs::memory_report after = ecs.memory_stats();
+    NEAT_TEST_ASSERT(after.components[0].capacity == 100);
+    NEAT_TEST_ASSERT(after.components[0].occupancy == 1.0);
+    NEAT_TEST_ASSERT(after.components[4].capacity == 100);
+    NEAT_TEST_ASSERT(after.free_used_bytes == 900 * sizeof(neat::ecs::entity_id));
+    NEAT_TEST_ASSERT(after.bytes - after.entity_bytes - after.free_used_bytes < (before.bytes - before.entity_bytes - before.free_used_bytes) / 4);
+    NEAT_TEST_ASSERT(after.free_entities == 900);
+    for (neat::ecs::entity_id entity = 0; entity < 100; entity++) {
+        NEAT_TEST_ASSERT(ecs.components.get<A>(entity)->a == static_cast<int>(entity));
+        NEAT_TEST_ASSERT(ecs.components.get<Point>(entity).get<&Point::x>() == static_cast<float>(entity));
+        NEAT_TEST_ASSERT(ecs.components.has<Enemy>(entity));
+        NEAT_TEST_ASSERT(ecs.components.has<Rare>(entity) == (entity % 10 == 0));
+    }
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<A, Enemy>()) == 100);
+
+    // The lists grow again when components are added past the trimmed storage
+    ecs.entities.create_many(1000);
+    ecs.components.add<A>(999, 5);
+    ecs.components.add<Point>(999, 1.0f, 2.0f);
+    ecs.components.add<Rare>(999, 3);
+    NEAT_TEST_ASSERT(ecs.components.get<A>(999)->a == 5);
+    NEAT_TEST_ASSERT(ecs.components.get<Rare>(999)->rare == 3);
+    NEAT_TEST_ASSERT(std::ranges::distance(ecs.iterate<A, Rare>()) == 11);
+}
+
 int main() {
     NEAT_TEST_RUN(test_deleted_entity_no_longer_exists);
     NEAT_TEST_RUN(test_deleted_entity_cant_be_deleted_again);
     NEAT_TEST_RUN(test_get_component_returns_same);
     NEAT_TEST_RUN(test_get_multiple_components);
     NEAT_TEST_RUN(test_system_types);
+    NEAT_TEST_RUN(test_iterate_is_lazy_view);
+    NEAT_TEST_RUN(test_iterate_sparse_across_words);
+    NEAT_TEST_RUN(test_iterate_selective_driver);
+    NEAT_TEST_RUN(test_query_filters);
+    NEAT_TEST_RUN(test_sparse_storage);
+    NEAT_TEST_RUN(test_archetype_engine);
+    NEAT_TEST_RUN(test_execute_parallel);
+    NEAT_TEST_RUN(test_execute_batched);
+    NEAT_TEST_RUN(test_execute_callables);
+    NEAT_TEST_RUN(test_singleton_components);
+    NEAT_TEST_RUN(test_scheduler);
+    NEAT_TEST_RUN(test_cached_query);
+    NEAT_TEST_RUN(test_bulk_entities);
+    NEAT_TEST_RUN(test_component_lifetimes);
+    NEAT_TEST_RUN(test_change_detection);
+    NEAT_TEST_RUN(test_command_buffer);
+    NEAT_TEST_RUN(test_memory_resource);
+    NEAT_TEST_RUN(test_soa_storage);
+    NEAT_TEST_RUN(test_tag_components);
+    NEAT_TEST_RUN(test_compact);
+    NEAT_TEST_RUN(test_snapshot);
+    NEAT_TEST_RUN(test_delta);
+    NEAT_TEST_RUN(test_profile);
+    NEAT_TEST_RUN(test_memory_stats);
 
     NEAT_TEST_PRINT_STATS();
 